@@ -0,0 +1,742 @@
+/**
+ * @file bclient.c
+ * @date 2026
+ *
+ * @brief Synthetic X client for the JWM benchmarks.
+ *
+ * Each scenario creates its own windows, drives JWM through one workload
+ * and prints the latency seen by the client. A request is timed from
+ * the moment it is sent until the X server reports the change JWM made
+ * in response (for example, the client window being mapped).
+ *
+ */
+
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XTest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/** Time to wait for JWM to respond to a request in microseconds. */
+#define TIMEOUT 2000000L
+
+/** Time to wait for a frame to follow the pointer in microseconds.
+ * The frame does not move while it is held by snapping.
+ */
+#define MOVE_TIMEOUT 50000L
+
+/** Size of the windows created by the scenarios. */
+#define WINDOW_WIDTH  200
+#define WINDOW_HEIGHT 100
+
+/** Latency samples of a scenario in microseconds. */
+typedef struct Samples {
+   long *values;
+   int count;
+   int size;
+   int timeouts;
+} Samples;
+
+static Display *display;
+static Window rootWindow;
+static int rootWidth;
+static int rootHeight;
+
+static long GetTime();
+static void AddSample(Samples *sp, long start);
+static void PrintSamples(const char *name, Samples *sp);
+static int CompareLong(const void *a, const void *b);
+static int WaitForEvent(Window w, int type, XEvent *event, long timeout);
+static int Barrier();
+static Window CreateWindow(int index, long desktop);
+static Window *MapWindows(int count, int desktops, Samples *sp);
+static void DestroyWindows(Window *windows, int count);
+static Atom GetAtom(const char *name);
+static long GetCardinal(Window w, Atom atom);
+static void SendMessage(Window w, Atom type, long data);
+static int WaitForDisplay();
+static int WaitForJWM();
+static int RunMap(int count);
+static int RunRetitle(int count, int changes);
+static int RunDesktop(int count, int switches);
+static int RunMove(int count, int steps);
+static int RunRestart(int count, int restarts);
+static void SetIcon(Window w, int index);
+static int IsFramed(Window w);
+static int RunIcons(int count, int restarts);
+
+/** Get the current time in microseconds. */
+long GetTime() {
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec * 1000000L + tv.tv_usec;
+}
+
+/** Add the time since start to a list of samples. */
+void AddSample(Samples *sp, long start) {
+   if(sp->count == sp->size) {
+      sp->size = sp->size ? sp->size * 2 : 256;
+      sp->values = realloc(sp->values, sp->size * sizeof(long));
+   }
+   sp->values[sp->count] = GetTime() - start;
+   sp->count += 1;
+}
+
+/** Compare two samples for qsort. */
+int CompareLong(const void *a, const void *b) {
+   const long x = *(const long*)a;
+   const long y = *(const long*)b;
+   return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/** Print the percentiles of a list of samples and release it. */
+void PrintSamples(const char *name, Samples *sp) {
+
+   long *v = sp->values;
+   int n = sp->count;
+
+   if(n == 0) {
+      printf("client %-10s no samples, %d timeouts\n", name, sp->timeouts);
+      return;
+   }
+
+   qsort(v, n, sizeof(long), CompareLong);
+   printf("client %-10s %6d samples  p50 %7ld us  p90 %7ld us"
+          "  p99 %7ld us  max %7ld us  %d timeouts\n",
+          name, n, v[n / 2], v[(n * 9) / 10], v[(n * 99) / 100], v[n - 1],
+          sp->timeouts);
+
+   free(sp->values);
+   memset(sp, 0, sizeof(Samples));
+
+}
+
+/** Wait for an event of the specified type on a window.
+ * @return 1 if the event arrived, 0 after timeout microseconds.
+ */
+int WaitForEvent(Window w, int type, XEvent *event, long timeout) {
+
+   struct timeval tv;
+   fd_set fds;
+   long start;
+   long left;
+   int fd;
+
+   fd = ConnectionNumber(display);
+   start = GetTime();
+   for(;;) {
+      if(XCheckTypedWindowEvent(display, w, type, event)) {
+         return 1;
+      }
+      left = timeout - (GetTime() - start);
+      if(left <= 0) {
+         return 0;
+      }
+      FD_ZERO(&fds);
+      FD_SET(fd, &fds);
+      tv.tv_sec = left / 1000000L;
+      tv.tv_usec = left % 1000000L;
+      select(fd + 1, &fds, NULL, NULL, &tv);
+   }
+
+}
+
+/** Wait until JWM has handled everything sent so far.
+ * JWM handles requests in order and answers _JWM_STATS by writing
+ * the _JWM_STATS property on the root window.
+ * @return 1 if JWM answered, 0 if it did not.
+ */
+int Barrier() {
+
+   const Atom stats = GetAtom("_JWM_STATS");
+   XEvent event;
+
+   SendMessage(rootWindow, stats, 0);
+   while(WaitForEvent(rootWindow, PropertyNotify, &event, TIMEOUT)) {
+      if(event.xproperty.atom == stats) {
+         return 1;
+      }
+   }
+   fprintf(stderr, "bclient: JWM did not answer\n");
+   return 0;
+
+}
+
+/** Look up an atom. */
+Atom GetAtom(const char *name) {
+   return XInternAtom(display, name, False);
+}
+
+/** Read a CARDINAL or WINDOW property (-1 if it is not set). */
+long GetCardinal(Window w, Atom atom) {
+
+   unsigned long count, extra;
+   unsigned char *data;
+   Atom type;
+   int format;
+   long result;
+
+   result = -1;
+   if(XGetWindowProperty(display, w, atom, 0, 1, False, AnyPropertyType,
+                         &type, &format, &count, &extra, &data) == Success) {
+      if(data && count > 0 && format == 32) {
+         result = *(long*)data;
+      }
+      if(data) {
+         XFree(data);
+      }
+   }
+   return result;
+
+}
+
+/** Send a client message to JWM. */
+void SendMessage(Window w, Atom type, long data) {
+
+   XEvent event;
+
+   memset(&event, 0, sizeof(event));
+   event.xclient.type = ClientMessage;
+   event.xclient.window = w;
+   event.xclient.message_type = type;
+   event.xclient.format = 32;
+   event.xclient.data.l[0] = data;
+   XSendEvent(display, rootWindow, False,
+              SubstructureRedirectMask | SubstructureNotifyMask, &event);
+   XFlush(display);
+
+}
+
+/** Create a client window (not mapped).
+ * @param index Used for the name and to spread the windows out.
+ * @param desktop The desktop to request or -1 for the current one.
+ */
+Window CreateWindow(int index, long desktop) {
+
+   char name[64];
+   XSizeHints hints;
+   Window w;
+   int x, y;
+
+   x = (index * 37) % (rootWidth - WINDOW_WIDTH);
+   y = (index * 23) % (rootHeight - WINDOW_HEIGHT);
+   w = XCreateSimpleWindow(display, rootWindow, x, y,
+                           WINDOW_WIDTH, WINDOW_HEIGHT, 0, 0,
+                           WhitePixel(display, DefaultScreen(display)));
+   XSelectInput(display, w, StructureNotifyMask);
+
+   /* Ask for the position so windows do not all cascade. */
+   hints.flags = USPosition;
+   hints.x = x;
+   hints.y = y;
+   XSetWMNormalHints(display, w, &hints);
+
+   snprintf(name, sizeof(name), "bench %d", index);
+   XStoreName(display, w, name);
+
+   if(desktop >= 0) {
+      XChangeProperty(display, w, GetAtom("_NET_WM_DESKTOP"), XA_CARDINAL,
+                      32, PropModeReplace, (unsigned char*)&desktop, 1);
+   }
+
+   return w;
+
+}
+
+/** Create and map windows, timing each until JWM reparents it.
+ * Windows on other desktops are not mapped by JWM, so the map is
+ * considered done when the window has a frame.
+ * @param count The number of windows.
+ * @param desktops Spread the windows over this many desktops (0 to put
+ * them on the current desktop).
+ * @param sp Where to store the latency of each map (may be NULL).
+ */
+Window *MapWindows(int count, int desktops, Samples *sp) {
+
+   Window *windows;
+   XEvent event;
+   long start;
+   int x;
+
+   windows = malloc(count * sizeof(Window));
+   for(x = 0; x < count; x++) {
+      windows[x] = CreateWindow(x, desktops > 0 ? x % desktops : -1);
+      start = GetTime();
+      XMapWindow(display, windows[x]);
+      XFlush(display);
+      if(WaitForEvent(windows[x], ReparentNotify, &event, TIMEOUT)) {
+         if(sp) {
+            AddSample(sp, start);
+         }
+      } else if(sp) {
+         sp->timeouts += 1;
+      }
+   }
+
+   return windows;
+
+}
+
+/** Destroy windows created by MapWindows. */
+void DestroyWindows(Window *windows, int count) {
+
+   int x;
+
+   for(x = 0; x < count; x++) {
+      XDestroyWindow(display, windows[x]);
+   }
+   free(windows);
+   Barrier();
+
+}
+
+/** Wait for the X server to accept connections.
+ * @return 1 on success, 0 on failure.
+ */
+int WaitForDisplay() {
+
+   int x;
+
+   for(x = 0; x < 100; x++) {
+      display = XOpenDisplay(NULL);
+      if(display) {
+         return 1;
+      }
+      usleep(100000);
+   }
+   fprintf(stderr, "bclient: could not open the display\n");
+   return 0;
+
+}
+
+/** Wait for JWM to manage the screen.
+ * @return 1 on success, 0 on failure.
+ */
+int WaitForJWM() {
+
+   const Atom check = GetAtom("_NET_SUPPORTING_WM_CHECK");
+   int x;
+
+   for(x = 0; x < 100; x++) {
+      if(GetCardinal(rootWindow, check) > 0) {
+         return 1;
+      }
+      usleep(100000);
+   }
+   fprintf(stderr, "bclient: JWM is not running\n");
+   return 0;
+
+}
+
+/** Map and unmap windows.
+ * Unmapped clients are reparented back to the root window by JWM.
+ */
+int RunMap(int count) {
+
+   Samples map, unmap;
+   Window *windows;
+   XEvent event;
+   long start;
+   int x;
+
+   memset(&map, 0, sizeof(map));
+   memset(&unmap, 0, sizeof(unmap));
+
+   windows = MapWindows(count, 0, &map);
+   Barrier();
+
+   for(x = 0; x < count; x++) {
+      start = GetTime();
+      XUnmapWindow(display, windows[x]);
+      XFlush(display);
+      if(WaitForEvent(windows[x], ReparentNotify, &event, TIMEOUT)) {
+         AddSample(&unmap, start);
+      } else {
+         unmap.timeouts += 1;
+      }
+   }
+
+   PrintSamples("map", &map);
+   PrintSamples("unmap", &unmap);
+   DestroyWindows(windows, count);
+   return 0;
+
+}
+
+/** Change the titles of windows as fast as possible.
+ * JWM does not answer title changes, so this reports the time for
+ * batches of changes to be handled.
+ */
+int RunRetitle(int count, int changes) {
+
+   const Atom netName = GetAtom("_NET_WM_NAME");
+   const Atom utf8 = GetAtom("UTF8_STRING");
+   const int batch = 100;
+   Samples samples;
+   Window *windows;
+   char name[64];
+   long start;
+   long total;
+   int x;
+
+   memset(&samples, 0, sizeof(samples));
+   windows = MapWindows(count, 0, NULL);
+   Barrier();
+
+   total = GetTime();
+   start = total;
+   for(x = 0; x < changes; x++) {
+      snprintf(name, sizeof(name), "bench title %d", x);
+      XChangeProperty(display, windows[x % count], netName, utf8, 8,
+                      PropModeReplace, (unsigned char*)name, strlen(name));
+      if((x + 1) % batch == 0) {
+         Barrier();
+         AddSample(&samples, start);
+         start = GetTime();
+      }
+   }
+   Barrier();
+   total = GetTime() - total;
+
+   PrintSamples("retitle100", &samples);
+   printf("client %-10s %d changes in %ld ms\n", "retitle", changes,
+          total / 1000);
+   DestroyWindows(windows, count);
+   return 0;
+
+}
+
+/** Switch desktops with windows on each desktop. */
+int RunDesktop(int count, int switches) {
+
+   const Atom current = GetAtom("_NET_CURRENT_DESKTOP");
+   Samples samples;
+   Window *windows;
+   XEvent event;
+   long desktops;
+   long start;
+   int x;
+
+   desktops = GetCardinal(rootWindow, GetAtom("_NET_NUMBER_OF_DESKTOPS"));
+   if(desktops < 2) {
+      fprintf(stderr, "bclient: the configuration needs two desktops\n");
+      return 1;
+   }
+
+   memset(&samples, 0, sizeof(samples));
+   windows = MapWindows(count, desktops, NULL);
+   Barrier();
+
+   for(x = 0; x < switches; x++) {
+      start = GetTime();
+      SendMessage(rootWindow, current, (x + 1) % desktops);
+      for(;;) {
+         if(!WaitForEvent(rootWindow, PropertyNotify, &event, TIMEOUT)) {
+            samples.timeouts += 1;
+            break;
+         } else if(event.xproperty.atom == current) {
+            AddSample(&samples, start);
+            break;
+         }
+      }
+   }
+
+   SendMessage(rootWindow, current, 0);
+   PrintSamples("desktop", &samples);
+   DestroyWindows(windows, count);
+   return 0;
+
+}
+
+/** Drag a window by its title bar past the others.
+ * The move mode and snapping come from the configuration; the time
+ * from each pointer motion to the frame moving is reported.
+ */
+int RunMove(int count, int steps) {
+
+   Window root, parent, *children;
+   unsigned int childCount;
+   Samples samples;
+   Window *windows;
+   Window frame;
+   XEvent event;
+   int dummy;
+   int x, y;
+   long start;
+   int step;
+
+   if(!XTestQueryExtension(display, &dummy, &dummy, &dummy, &dummy)) {
+      fprintf(stderr, "bclient: the XTEST extension is not available\n");
+      return 1;
+   }
+
+   memset(&samples, 0, sizeof(samples));
+   windows = MapWindows(count, 0, NULL);
+   Barrier();
+
+   /* Find the frame of the first window and watch it move. */
+   if(!XQueryTree(display, windows[0], &root, &parent,
+                  &children, &childCount)) {
+      fprintf(stderr, "bclient: could not find the frame\n");
+      return 1;
+   }
+   if(children) {
+      XFree(children);
+   }
+   frame = parent;
+   XRaiseWindow(display, frame);
+   XSelectInput(display, frame, StructureNotifyMask);
+   XTranslateCoordinates(display, frame, rootWindow, 0, 0,
+                         &x, &y, &root);
+
+   /* Grab the title bar away from the buttons. JWM only handles the
+    * pointer while moving, so wait instead of using Barrier. */
+   x += 20;
+   y += 8;
+   XTestFakeMotionEvent(display, -1, x, y, CurrentTime);
+   XTestFakeButtonEvent(display, 1, True, CurrentTime);
+   XSync(display, False);
+   usleep(200000);
+
+   for(step = 0; step < steps; step++) {
+      x += (step / 100) % 2 ? -3 : 3;
+      y += (step / 50) % 2 ? -2 : 2;
+      start = GetTime();
+      XTestFakeMotionEvent(display, -1, x, y, CurrentTime);
+      XFlush(display);
+      if(WaitForEvent(frame, ConfigureNotify, &event,
+                      MOVE_TIMEOUT)) {
+         AddSample(&samples, start);
+      } else {
+         samples.timeouts += 1;
+      }
+   }
+
+   XTestFakeButtonEvent(display, 1, False, CurrentTime);
+   XSync(display, False);
+
+   /* Timeouts are motions that did not move the frame (snapping). */
+   PrintSamples("move", &samples);
+   DestroyWindows(windows, count);
+   return 0;
+
+}
+
+/** Restart JWM with windows mapped. */
+int RunRestart(int count, int restarts) {
+
+   const Atom check = GetAtom("_NET_SUPPORTING_WM_CHECK");
+   const Atom restart = GetAtom("_JWM_RESTART");
+   Samples samples;
+   Window *windows;
+   XEvent event;
+   long start;
+   long old;
+   int x;
+
+   memset(&samples, 0, sizeof(samples));
+   windows = MapWindows(count, 0, NULL);
+   Barrier();
+
+   /* JWM creates a new supporting window each time it starts. */
+   for(x = 0; x < restarts; x++) {
+      old = GetCardinal(rootWindow, check);
+      start = GetTime();
+      SendMessage(rootWindow, restart, 0);
+      for(;;) {
+         if(!WaitForEvent(rootWindow, PropertyNotify, &event, TIMEOUT)) {
+            samples.timeouts += 1;
+            break;
+         } else if(event.xproperty.atom == check
+                   && event.xproperty.state == PropertyNewValue
+                   && GetCardinal(rootWindow, check) != old) {
+            AddSample(&samples, start);
+            break;
+         }
+      }
+      Barrier();
+   }
+
+   PrintSamples("restart", &samples);
+   DestroyWindows(windows, count);
+   return 0;
+
+}
+
+/** Set _NET_WM_ICON on a window.
+ * Every other window gets the same image so icons are shared. Every
+ * third window only has a 64x64 image, which has more pixels than JWM
+ * has buckets in its icon hash (128), so JWM must use it.
+ */
+void SetIcon(Window w, int index) {
+
+   static const int sizes[] = { 16, 32, 64 };
+   const int first = index % 3 == 2 ? 2 : 0;
+   const int count = index % 3 == 2 ? 3 : 2;
+   unsigned long *data;
+   unsigned long length;
+   unsigned long offset;
+   int pattern;
+   int x, y;
+
+   pattern = index % 2 ? index : 0;
+   length = 0;
+   for(x = first; x < count; x++) {
+      length += 2 + sizes[x] * sizes[x];
+   }
+
+   data = malloc(length * sizeof(unsigned long));
+   offset = 0;
+   for(x = first; x < count; x++) {
+      data[offset++] = sizes[x];
+      data[offset++] = sizes[x];
+      for(y = 0; y < sizes[x] * sizes[x]; y++) {
+         data[offset++] = 0xFF000000UL | ((y * 2654435761UL + pattern)
+                                          & 0x00FFFFFFUL);
+      }
+   }
+
+   XChangeProperty(display, w, GetAtom("_NET_WM_ICON"), XA_CARDINAL, 32,
+                   PropModeReplace, (unsigned char*)data, length);
+   free(data);
+
+}
+
+/** Determine if JWM has put a window in a frame. */
+int IsFramed(Window w) {
+
+   Window root, parent, *children;
+   unsigned int count;
+
+   if(!XQueryTree(display, w, &root, &parent, &children, &count)) {
+      return 0;
+   }
+   if(children) {
+      XFree(children);
+   }
+   return parent != root;
+
+}
+
+/** Restart JWM with clients that have _NET_WM_ICON.
+ * The icons are kept across a restart, so this checks that JWM still
+ * manages every window afterwards.
+ * @return 0 on success, 1 if JWM stopped answering or lost a window.
+ */
+int RunIcons(int count, int restarts) {
+
+   const Atom check = GetAtom("_NET_SUPPORTING_WM_CHECK");
+   const Atom restart = GetAtom("_JWM_RESTART");
+   Window *windows;
+   XEvent event;
+   long old;
+   int result;
+   int x;
+
+   windows = malloc(count * sizeof(Window));
+   for(x = 0; x < count; x++) {
+      windows[x] = CreateWindow(x, -1);
+      SetIcon(windows[x], x);
+      XMapWindow(display, windows[x]);
+      XFlush(display);
+      WaitForEvent(windows[x], ReparentNotify, &event, TIMEOUT);
+   }
+
+   result = Barrier() ? 0 : 1;
+   for(x = 0; x < restarts && result == 0; x++) {
+
+      /* Events sent while JWM starts are discarded, so wait for the
+       * new supporting window before using Barrier. */
+      old = GetCardinal(rootWindow, check);
+      SendMessage(rootWindow, restart, 0);
+      for(;;) {
+         if(!WaitForEvent(rootWindow, PropertyNotify, &event, TIMEOUT)) {
+            result = 1;
+            break;
+         } else if(event.xproperty.atom == check
+                   && event.xproperty.state == PropertyNewValue
+                   && GetCardinal(rootWindow, check) != old) {
+            break;
+         }
+      }
+      if(result || !Barrier()) {
+         fprintf(stderr, "bclient: JWM did not restart\n");
+         result = 1;
+         break;
+      }
+
+      /* Change an icon so a new one is read after the restart. */
+      SetIcon(windows[x % count], x + count);
+      if(!Barrier()) {
+         result = 1;
+      }
+   }
+
+   for(x = 0; x < count && result == 0; x++) {
+      if(!IsFramed(windows[x])) {
+         fprintf(stderr, "bclient: window %d is not managed\n", x);
+         result = 1;
+      }
+   }
+
+   printf("client %-10s %s\n", "icons", result ? "FAILED" : "ok");
+   DestroyWindows(windows, count);
+   return result;
+
+}
+
+/** Run a scenario. */
+int main(int argc, char *argv[]) {
+
+   const char *scenario;
+   int count;
+   int repeat;
+
+   if(argc < 2) {
+      fprintf(stderr, "usage: bclient wait|ready|map|retitle|desktop|move"
+                      "|restart|icons [windows] [repeat]\n");
+      return 2;
+   }
+   scenario = argv[1];
+   count = argc > 2 ? atoi(argv[2]) : 0;
+   repeat = argc > 3 ? atoi(argv[3]) : 0;
+
+   if(!WaitForDisplay()) {
+      return 1;
+   }
+   rootWindow = DefaultRootWindow(display);
+   rootWidth = DisplayWidth(display, DefaultScreen(display));
+   rootHeight = DisplayHeight(display, DefaultScreen(display));
+   if(!strcmp(scenario, "wait")) {
+      return 0;
+   } else if(!WaitForJWM()) {
+      return 1;
+   } else if(!strcmp(scenario, "ready")) {
+      return 0;
+   }
+   XSelectInput(display, rootWindow, PropertyChangeMask);
+
+   if(!strcmp(scenario, "map")) {
+      return RunMap(count > 0 ? count : 1000);
+   } else if(!strcmp(scenario, "retitle")) {
+      return RunRetitle(count > 0 ? count : 50, repeat > 0 ? repeat : 20000);
+   } else if(!strcmp(scenario, "desktop")) {
+      return RunDesktop(count > 0 ? count : 200, repeat > 0 ? repeat : 200);
+   } else if(!strcmp(scenario, "move")) {
+      return RunMove(count > 0 ? count : 50, repeat > 0 ? repeat : 1000);
+   } else if(!strcmp(scenario, "restart")) {
+      return RunRestart(count > 0 ? count : 200, repeat > 0 ? repeat : 10);
+   } else if(!strcmp(scenario, "icons")) {
+      return RunIcons(count > 0 ? count : 20, repeat > 0 ? repeat : 5);
+   }
+
+   fprintf(stderr, "bclient: unknown scenario: %s\n", scenario);
+   return 2;
+
+}
@@ -0,0 +1,71 @@
+#!/bin/sh
+# Run the JWM benchmarks on a virtual X server.
+#
+# usage: run.sh [jwm] [config] [scenario...]
+#
+# JWM is started on Xvfb with the configuration as ~/.jwmrc in a
+# temporary home directory. For each scenario, bclient prints the
+# latency seen by the client, then the CPU time used by JWM and the
+# timing of each JWM handler (from "jwm -stats") are printed.
+#
+# Set BENCH_DISPLAY to use a display other than :99.
+
+JWM=${1:-../src/jwm}
+CONFIG=${2:-stress.jwmrc}
+if [ $# -gt 2 ]; then shift 2; else set --; fi
+SCENARIOS=${*:-map retitle desktop move restart}
+BENCH_DISPLAY=${BENCH_DISPLAY:-:99}
+HERE=`dirname "$0"`
+
+if ! command -v Xvfb >/dev/null 2>&1; then
+   echo "run.sh: Xvfb is required" >&2
+   exit 1
+fi
+if [ ! -x "$JWM" ] || [ ! -f "$CONFIG" ]; then
+   echo "run.sh: $JWM or $CONFIG not found" >&2
+   exit 1
+fi
+
+TMP=`mktemp -d "${TMPDIR:-/tmp}/jwm-bench.XXXXXX"` || exit 1
+cp "$CONFIG" "$TMP/.jwmrc"
+XVFB_PID=
+JWM_PID=
+trap 'kill $JWM_PID $XVFB_PID 2>/dev/null; rm -rf "$TMP"' 0
+trap 'exit 1' 1 2 15
+
+Xvfb "$BENCH_DISPLAY" -screen 0 1280x1024x24 -nolisten tcp \
+   >"$TMP/xvfb.log" 2>&1 &
+XVFB_PID=$!
+DISPLAY=$BENCH_DISPLAY
+export DISPLAY
+"$HERE/bclient" wait || exit 1
+
+HOME=$TMP "$JWM" >"$TMP/jwm.log" 2>&1 &
+JWM_PID=$!
+"$HERE/bclient" ready || exit 1
+
+# Print the user and system time used by JWM in milliseconds.
+cputime() {
+   awk -v hz=`getconf CLK_TCK` \
+      '{ sub(/.*\) /, ""); print int(($12 + $13) * 1000 / hz) }' \
+      "/proc/$JWM_PID/stat"
+}
+
+status=0
+for scenario in $SCENARIOS; do
+   echo "== $scenario"
+   "$JWM" -stats >"$TMP/before" 2>/dev/null
+   before=`cputime`
+   if ! "$HERE/bclient" "$scenario"; then
+      echo "run.sh: $scenario failed" >&2
+      status=1
+   fi
+   "$JWM" -stats >"$TMP/after" 2>/dev/null
+   after=`cputime`
+   echo "jwm    cpu time $((after - before)) ms"
+   awk -f "$HERE/stats.awk" "$TMP/before" "$TMP/after"
+done
+
+"$JWM" -exit
+wait $JWM_PID
+exit $status
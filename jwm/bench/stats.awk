@@ -0,0 +1,69 @@
+# Compare two "jwm -stats" reports taken before and after a scenario.
+# For each handler that ran in between, print the number of calls, the
+# time spent and percentiles taken from the difference of the
+# histograms. A percentile is the bucket bound it falls under.
+#
+# usage: awk -f stats.awk before after
+
+FNR == 1 {
+   file += 1
+}
+
+# "Name  count calls  total ms  avg us avg  max us max"
+/^[^ ]/ {
+   name = $1
+   if($3 != "calls") {
+      name = ""
+      next
+   }
+   if(file == 1) {
+      calls0[name] = $2
+      ms0[name] = $4
+   } else {
+      calls1[name] = $2
+      ms1[name] = $4
+      order[++count] = name
+   }
+   next
+}
+
+# "  <2 us: 5  <4 us: 10  ...  >=524288 us: 1"
+/^  / && name != "" {
+   for(i = 1; i + 2 <= NF; i += 3) {
+      bound = $i
+      key = name SUBSEP bound
+      if(file == 1) {
+         hist0[key] = $(i + 2)
+      } else {
+         hist1[key] = $(i + 2)
+         bounds[name] = bounds[name] " " bound
+      }
+   }
+}
+
+function percentile(name, total, p,    n, b, i, sum, need) {
+   need = int(total * p + 0.999999)
+   n = split(bounds[name], b, " ")
+   sum = 0
+   for(i = 1; i <= n; i++) {
+      sum += hist1[name SUBSEP b[i]] - hist0[name SUBSEP b[i]]
+      if(sum >= need) {
+         return b[i]
+      }
+   }
+   return "?"
+}
+
+END {
+   for(i = 1; i <= count; i++) {
+      name = order[i]
+      calls = calls1[name] - calls0[name]
+      if(calls <= 0) {
+         continue
+      }
+      printf("jwm    %-18s %7d calls %9.1f ms  p50 %8s us  p90 %8s us" \
+             "  p99 %8s us\n", name, calls, ms1[name] - ms0[name],
+             percentile(name, calls, 0.5), percentile(name, calls, 0.9),
+             percentile(name, calls, 0.99))
+   }
+}
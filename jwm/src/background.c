@@ -35,12 +35,22 @@ typedef struct BackgroundNode {
    char *value;
    Pixmap pixmap;
    Window window;
+   time_t modified;              /**< Time of the image file. */
    struct BackgroundNode *next;  /**< Next background in the list. */
 } BackgroundNode;
 
 /** Linked list of backgrounds. */
 static BackgroundNode *backgrounds;
 
+/** Backgrounds kept from before a restart or reload.
+ * The pixmaps and windows are reused if the new configuration
+ * contains the same background and the root window size is unchanged.
+ */
+static BackgroundNode *retainedBackgrounds;
+static BackgroundNode *retainedLast;
+static int retainedWidth;
+static int retainedHeight;
+
 /** The default background. */
 static BackgroundNode *defaultBackground;
 
@@ -50,6 +60,9 @@ static BackgroundNode *lastBackground;
 static void LoadSolidBackground(BackgroundNode *bp);
 static void LoadGradientBackground(BackgroundNode *bp);
 static void LoadImageBackground(BackgroundNode *bp);
+static char ReuseBackground(BackgroundNode *bp);
+static void ReleaseBackground(BackgroundNode *bp);
+static time_t GetFileTime(const char *path);
 
 /** Initialize any data needed for background support. */
 void InitializeBackgrounds() {
@@ -65,6 +78,15 @@ void StartupBackgrounds() {
 
    for(bp = backgrounds; bp; bp = bp->next) {
 
+      if(bp->desktop == -1) {
+         defaultBackground = bp;
+      }
+
+      /* Use the background from before a restart if it is the same. */
+      if(ReuseBackground(bp)) {
+         continue;
+      }
+
       /* Load background data. */
       switch(bp->type) {
       case BACKGROUND_SOLID:
@@ -85,30 +107,109 @@ void StartupBackgrounds() {
          break;
       }
 
-      if(bp->desktop == -1) {
-         defaultBackground = bp;
-      }
+   }
 
+   /* Release backgrounds from before a restart that were not used. */
+   while(retainedBackgrounds) {
+      bp = retainedBackgrounds->next;
+      ReleaseBackground(retainedBackgrounds);
+      Release(retainedBackgrounds->value);
+      Release(retainedBackgrounds);
+      retainedBackgrounds = bp;
    }
+   retainedLast = NULL;
 
 }
 
-/** Shutdown background support. */
+/** Shutdown background support.
+ * When restarting or reloading, the backgrounds are kept (and the
+ * current one is left on the screen) so they can be reused by
+ * StartupBackgrounds.
+ */
 void ShutdownBackgrounds() {
 
    BackgroundNode *bp;
 
+   if(shouldRestart || shouldReload) {
+      retainedWidth = rootWidth;
+      retainedHeight = rootHeight;
+      retainedLast = lastBackground;
+      retainedBackgrounds = backgrounds;
+      backgrounds = NULL;
+      return;
+   }
+
    for(bp = backgrounds; bp; bp = bp->next) {
-      if(bp->pixmap != None) {
-         JXFreePixmap(display, bp->pixmap);
-         bp->pixmap = None;
+      ReleaseBackground(bp);
+   }
+
+}
+
+/** Attempt to reuse a background kept across a restart. */
+char ReuseBackground(BackgroundNode *bp) {
+
+   BackgroundNode *rp;
+
+   if(rootWidth != retainedWidth || rootHeight != retainedHeight) {
+      return 0;
+   }
+
+   for(rp = retainedBackgrounds; rp; rp = rp->next) {
+      if(   rp->window != None
+         && rp->type == bp->type
+         && !strcmp(rp->value, bp->value)) {
+         break;
       }
-      if(bp->window != None) {
-         JXDestroyWindow(display, bp->window);
-         bp->window = None;
+   }
+   if(!rp) {
+      return 0;
+   }
+
+   /* Make sure an image has not changed. */
+   if(bp->type == BACKGROUND_STRETCH || bp->type == BACKGROUND_TILE) {
+      if(GetFileTime(bp->value) != rp->modified) {
+         return 0;
       }
    }
 
+   bp->pixmap = rp->pixmap;
+   bp->window = rp->window;
+   bp->modified = rp->modified;
+   rp->pixmap = None;
+   rp->window = None;
+
+   /* The background on the screen does not need to be loaded again. */
+   if(rp == retainedLast) {
+      lastBackground = bp;
+   }
+
+   return 1;
+
+}
+
+/** Free the pixmap and window of a background. */
+void ReleaseBackground(BackgroundNode *bp) {
+   if(bp->pixmap != None) {
+      JXFreePixmap(display, bp->pixmap);
+      bp->pixmap = None;
+   }
+   if(bp->window != None) {
+      JXDestroyWindow(display, bp->window);
+      bp->window = None;
+   }
+}
+
+/** Get the modification time of a file (0 if it does not exist). */
+time_t GetFileTime(const char *path) {
+
+   struct stat sbuf;
+
+   if(stat(path, &sbuf) == 0) {
+      return sbuf.st_mtime;
+   } else {
+      return 0;
+   }
+
 }
 
 /** Release any data needed for background support. */
@@ -158,6 +259,12 @@ void SetBackground(int desktop, const char *type, const char *value) {
    bp->desktop = desktop;
    bp->type = bgType;
    bp->value = CopyString(value);
+   bp->pixmap = None;
+   bp->window = None;
+   bp->modified = 0;
+   if(bgType == BACKGROUND_STRETCH || bgType == BACKGROUND_TILE) {
+      ExpandPath(&bp->value);
+   }
 
    /* Insert the node into the list. */
    bp->next = backgrounds;
@@ -213,6 +320,9 @@ void LoadBackground(int desktop) {
    JXClearWindow(display, bp->window);
    JXMapWindow(display, bp->window);
 
+   /* Windows created after startup are above the clients. */
+   JXLowerWindow(display, bp->window);
+
    SetPixmapAtom(rootWindow, ATOM_XSETROOT_ID, bp->window);
 
 }
@@ -293,7 +403,7 @@ void LoadImageBackground(BackgroundNode *bp) {
    int width, height;
 
    /* Load the icon. */
-   ExpandPath(&bp->value);
+   bp->modified = GetFileTime(bp->value);
    ip = LoadNamedIcon(bp->value);
    if(JUNLIKELY(!ip)) {
       bp->pixmap = None;
@@ -14,6 +14,7 @@
 #include "font.h"
 #include "error.h"
 #include "misc.h"
+#include "stats.h"
 
 typedef unsigned char BorderPixmapDataType[32];
 
@@ -48,10 +49,37 @@ static Region borderRegion = NULL;
 static GC borderGC;
 
 #ifdef USE_SHAPE
-static Pixmap shapePixmap;
-static int shapePixmapWidth;
-static int shapePixmapHeight;
+
+/* Must be a power of two. */
+#define SHAPE_HASH_SIZE 64
+
+/** Number of shape masks to keep. */
+#define SHAPE_MASK_COUNT 8
+
+/** Shape mask for a window size (shared by windows of the same size). */
+typedef struct ShapeMaskNode {
+   Pixmap pixmap;
+   int width;
+   int height;
+   unsigned int lastUsed;
+} ShapeMaskNode;
+
+/** Size of the shape last applied to a window. */
+typedef struct ShapedWindowNode {
+   Window window;
+   int width;
+   int height;
+   struct ShapedWindowNode *next;
+} ShapedWindowNode;
+
+static ShapeMaskNode shapeMasks[SHAPE_MASK_COUNT];
+static unsigned int shapeMaskCounter;
+static ShapedWindowNode *shapedWindows[SHAPE_HASH_SIZE];
 static GC shapeGC;
+
+static Pixmap GetShapeMask(Window w, int width, int height);
+static ShapedWindowNode **FindShapedWindow(Window w);
+
 #endif
 
 static void DrawBorderHelper(const ClientNode *np, int drawIcon);
@@ -92,11 +120,11 @@ void StartupBorders() {
    gcValues.graphics_exposures = False;
    borderGC = JXCreateGC(display, rootWindow, gcMask, &gcValues);
 
-#if defined(USE_SHAPE) && defined(USE_XMU)
-   shapePixmap = None;
+#ifdef USE_SHAPE
+   memset(shapeMasks, 0, sizeof(shapeMasks));
+   memset(shapedWindows, 0, sizeof(shapedWindows));
+   shapeMaskCounter = 0;
    shapeGC = None;
-   shapePixmapWidth = 0;
-   shapePixmapHeight = 0;
 #endif
 
 }
@@ -105,6 +133,9 @@ void StartupBorders() {
 void ShutdownBorders() {
 
    int x;
+#ifdef USE_SHAPE
+   ShapedWindowNode *sp;
+#endif
 
    JXFreeGC(display, borderGC);
 
@@ -112,10 +143,19 @@ void ShutdownBorders() {
       JXFreePixmap(display, pixmaps[x]);
    }
 
-#if defined(USE_SHAPE) && defined(USE_XMU)
-   if(shapePixmap != None) {
-      JXFreePixmap(display, shapePixmap);
-      shapePixmap = None;
+#ifdef USE_SHAPE
+   for(x = 0; x < SHAPE_MASK_COUNT; x++) {
+      if(shapeMasks[x].pixmap != None) {
+         JXFreePixmap(display, shapeMasks[x].pixmap);
+         shapeMasks[x].pixmap = None;
+      }
+   }
+   for(x = 0; x < SHAPE_HASH_SIZE; x++) {
+      while(shapedWindows[x]) {
+         sp = shapedWindows[x]->next;
+         Release(shapedWindows[x]);
+         shapedWindows[x] = sp;
+      }
    }
    if(shapeGC != None) {
       JXFreeGC(display, shapeGC);
@@ -247,6 +287,7 @@ BorderActionType GetBorderActionType(const ClientNode *np, int x, int y) {
 void DrawBorder(const ClientNode *np, const XExposeEvent *expose) {
 
    XRectangle rect;
+   ProfileTime start;
    int drawIcon;
    int temp;
 
@@ -330,7 +371,9 @@ void DrawBorder(const ClientNode *np, const XExposeEvent *expose) {
    }
 
    /* Do the actual drawing. */
+   start = StartProfile();
    DrawBorderHelper(np, drawIcon);
+   StopProfile(PROFILE_DRAW_BORDER, start);
 
    /* We no longer need the region, release it. */
    if(expose) {
@@ -596,6 +639,45 @@ void ExposeCurrentDesktop() {
 
 }
 
+/** Fit the frames of all clients to the current window style.
+ * This is used after the window style is reloaded, which may change
+ * the border width, the title height and the colors. Clients keep
+ * their size and position.
+ */
+void UpdateBorders() {
+
+   ClientNode *np;
+   int north, south, east, west;
+   int height;
+   int layer;
+
+   for(layer = 0; layer < LAYER_COUNT; layer++) {
+      for(np = nodes[layer]; np; np = np->next) {
+
+         GetBorderSize(np, &north, &south, &east, &west);
+         height = north + south;
+         if(!(np->state.status & STAT_SHADED)) {
+            height += np->height;
+         }
+
+         JXSetWindowBackground(display, np->parent,
+                               colors[COLOR_TITLE_BG2]);
+         ResetRoundedRectWindow(np->parent);
+         ShapeRoundedRectWindow(np->parent,
+            np->width + east + west, height);
+         JXMoveResizeWindow(display, np->parent,
+            np->x - west, np->y - north,
+            np->width + east + west, height);
+         JXMoveWindow(display, np->window, west, north);
+         SendConfigureEvent(np);
+
+      }
+   }
+
+   ExposeCurrentDesktop();
+
+}
+
 /** Get the size of the borders for a client. */
 void GetBorderSize(const ClientNode *np,
    int *north, int *south, int *east, int *west) {
@@ -810,37 +892,125 @@ void FillRoundedRectangle(Drawable d, GC gc, int x, int y,
 /** Clear the shape mask of a window. */
 void ResetRoundedRectWindow(Window w) {
 #ifdef USE_SHAPE
+   ForgetRoundedRectWindow(w);
    JXShapeCombineMask(display, w, ShapeBounding, 0, 0, None, ShapeSet);
 #endif
 }
+
+/** Forget the shape applied to a window. */
+void ForgetRoundedRectWindow(Window w) {
+#ifdef USE_SHAPE
+
+   ShapedWindowNode **spp;
+   ShapedWindowNode *sp;
+
+   spp = FindShapedWindow(w);
+   if(*spp) {
+      sp = *spp;
+      *spp = sp->next;
+      Release(sp);
+   }
+
+#endif
+}
  
-/** Set the shape mask on a window to give a rounded boarder. */
+/** Set the shape mask on a window to give a rounded boarder.
+ * Nothing is sent to the server if the window already has the
+ * shape for this size.
+ */
 void ShapeRoundedRectWindow(Window w, int width, int height) {
 #ifdef USE_SHAPE
 
-   if(width > shapePixmapWidth || height > shapePixmapHeight) {
-      if(shapePixmap != None) {
-         JXFreePixmap(display, shapePixmap);
+   ShapedWindowNode **spp;
+   ShapedWindowNode *sp;
+
+   spp = FindShapedWindow(w);
+   sp = *spp;
+   if(sp) {
+      if(sp->width == width && sp->height == height) {
+         return;
       }
-      shapePixmap = JXCreatePixmap(display, w, width, height, 1);
-      if(shapeGC == None) {
-         shapeGC = JXCreateGC(display, shapePixmap, 0, NULL);
+   } else {
+      sp = Allocate(sizeof(ShapedWindowNode));
+      sp->window = w;
+      sp->next = NULL;
+      *spp = sp;
+   }
+   sp->width = width;
+   sp->height = height;
+
+   JXShapeCombineMask(display, w, ShapeBounding, 0, 0,
+                      GetShapeMask(w, width, height), ShapeSet);
+
+#endif
+}
+
+#ifdef USE_SHAPE
+
+/** Find the shape record for a window.
+ * This returns the link to the record (pointing to NULL if not found).
+ */
+ShapedWindowNode **FindShapedWindow(Window w) {
+
+   ShapedWindowNode **spp;
+
+   spp = &shapedWindows[w & (SHAPE_HASH_SIZE - 1)];
+   while(*spp && (*spp)->window != w) {
+      spp = &(*spp)->next;
+   }
+
+   return spp;
+
+}
+
+/** Get the rounded rectangle shape mask for a window size.
+ * Masks are cached by size, replacing the least recently used one.
+ */
+Pixmap GetShapeMask(Window w, int width, int height) {
+
+   ShapeMaskNode *mp;
+   int x;
+
+   mp = &shapeMasks[0];
+   for(x = 0; x < SHAPE_MASK_COUNT; x++) {
+      if(shapeMasks[x].pixmap != None
+         && shapeMasks[x].width == width
+         && shapeMasks[x].height == height) {
+         shapeMasks[x].lastUsed = ++shapeMaskCounter;
+         return shapeMasks[x].pixmap;
+      }
+      if(shapeMasks[x].pixmap == None) {
+         mp = &shapeMasks[x];
+         break;
+      }
+      if(shapeMasks[x].lastUsed < mp->lastUsed) {
+         mp = &shapeMasks[x];
       }
-      shapePixmapWidth = width;
-      shapePixmapHeight = height;
+   }
+
+   if(mp->pixmap != None) {
+      JXFreePixmap(display, mp->pixmap);
+   }
+   mp->pixmap = JXCreatePixmap(display, w, width, height, 1);
+   mp->width = width;
+   mp->height = height;
+   mp->lastUsed = ++shapeMaskCounter;
+   if(shapeGC == None) {
+      shapeGC = JXCreateGC(display, mp->pixmap, 0, NULL);
    }
 
    JXSetForeground(display, shapeGC, 0);
-   JXFillRectangle(display, shapePixmap, shapeGC, 0, 0,
+   JXFillRectangle(display, mp->pixmap, shapeGC, 0, 0,
                    width + 1, height + 1);
 
    /* Corner bound radius -1 to allow slightly better outline drawing */
    JXSetForeground(display, shapeGC, 1);
-   FillRoundedRectangle(shapePixmap, shapeGC, 0, 0, width, height,
+   FillRoundedRectangle(mp->pixmap, shapeGC, 0, 0, width, height,
                         CORNER_RADIUS - 1);
-   
-   JXShapeCombineMask(display, w, ShapeBounding, 0, 0, shapePixmap, ShapeSet);
 
-#endif
+   return mp->pixmap;
+
 }
 
+#endif /* USE_SHAPE */
+
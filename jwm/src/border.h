@@ -87,12 +87,22 @@ void SetTitleHeight(const char *str);
 /** Redraw all borders on the current desktop. */
 void ExposeCurrentDesktop();
 
+/** Fit client frames to the current window style and redraw them. */
+void UpdateBorders();
+
 /** Reset a rounded rectangle window.
  * @param w The window.
  */
 void ResetRoundedRectWindow(Window w);
 
+/** Forget the shape applied to a window.
+ * This must be called before destroying a shaped window.
+ * @param w The window.
+ */
+void ForgetRoundedRectWindow(Window w);
+
 /** Shape a rounded rectangle window.
+ * The shape is only sent to the server when the size changes.
  * @param w The window to shape.
  * @param width The width of the window.
  * @param height The height of the window.
@@ -0,0 +1,226 @@
+/**
+ * @file cache.c
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Pixmap cache.
+ *
+ * Scaled icons and rendered menus keep server pixmaps around so they
+ * can be drawn again quickly. The entries are kept in least recently
+ * used order and the oldest ones are released when the total size
+ * exceeds the budget.
+ *
+ */
+
+#include "jwm.h"
+#include "cache.h"
+#include "error.h"
+#include "main.h"
+
+/** Default size budget in kilobytes. */
+#define DEFAULT_CACHE_SIZE 4096
+
+/** Largest size budget in kilobytes. */
+#define MAX_CACHE_SIZE (1024 * 1024)
+
+static CacheEntry *cacheHead;
+static CacheEntry *cacheTail;
+static CacheStats cacheStats;
+
+static void UnlinkCacheEntry(CacheEntry *entry);
+static void EvictCacheEntries(unsigned long size);
+
+/** Initialize cache data.
+ * Entries kept across a restart stay in the cache.
+ */
+void InitializeCache() {
+   cacheStats.hits = 0;
+   cacheStats.misses = 0;
+   cacheStats.evictions = 0;
+   cacheStats.peak = cacheStats.bytes;
+   cacheStats.limit = DEFAULT_CACHE_SIZE * 1024UL;
+}
+
+/** Startup the cache. */
+void StartupCache() {
+}
+
+/** Shutdown the cache.
+ * Owners remove their entries as they shut down, so this only
+ * releases whatever is left. When restarting, what is left belongs
+ * to icons that are kept, so nothing is released.
+ */
+void ShutdownCache() {
+
+   CacheEntry *entry;
+
+   while(cacheTail && !shouldRestart) {
+      entry = cacheTail;
+      UnlinkCacheEntry(entry);
+      (entry->Release)(entry->object);
+      Release(entry);
+   }
+
+}
+
+/** Destroy cache data. */
+void DestroyCache() {
+}
+
+/** Add an object to the cache. */
+CacheEntry *AddCacheEntry(void *object, unsigned long size,
+                          CacheReleaseFunc release) {
+
+   CacheEntry *entry;
+
+   EvictCacheEntries(size);
+
+   entry = Allocate(sizeof(CacheEntry));
+   entry->object = object;
+   entry->Release = release;
+   entry->size = size;
+   entry->locked = 0;
+
+   entry->prev = NULL;
+   entry->next = cacheHead;
+   if(cacheHead) {
+      cacheHead->prev = entry;
+   } else {
+      cacheTail = entry;
+   }
+   cacheHead = entry;
+
+   cacheStats.misses += 1;
+   cacheStats.entries += 1;
+   cacheStats.bytes += size;
+   if(cacheStats.bytes > cacheStats.peak) {
+      cacheStats.peak = cacheStats.bytes;
+   }
+
+   return entry;
+
+}
+
+/** Mark a cached object as used. */
+void TouchCacheEntry(CacheEntry *entry) {
+
+   Assert(entry);
+
+   cacheStats.hits += 1;
+   if(entry != cacheHead) {
+
+      entry->prev->next = entry->next;
+      if(entry->next) {
+         entry->next->prev = entry->prev;
+      } else {
+         cacheTail = entry->prev;
+      }
+
+      entry->prev = NULL;
+      entry->next = cacheHead;
+      cacheHead->prev = entry;
+      cacheHead = entry;
+
+   }
+
+}
+
+/** Remove an object from the cache without releasing it. */
+void RemoveCacheEntry(CacheEntry *entry) {
+   if(entry) {
+      UnlinkCacheEntry(entry);
+      Release(entry);
+   }
+}
+
+/** Prevent an object from being evicted. */
+void LockCacheEntry(CacheEntry *entry) {
+   Assert(entry);
+   entry->locked += 1;
+}
+
+/** Allow an object to be evicted again. */
+void UnlockCacheEntry(CacheEntry *entry) {
+   Assert(entry);
+   Assert(entry->locked > 0);
+   entry->locked -= 1;
+}
+
+/** Unlink an entry from the cache and update the counters. */
+void UnlinkCacheEntry(CacheEntry *entry) {
+
+   if(entry->prev) {
+      entry->prev->next = entry->next;
+   } else {
+      cacheHead = entry->next;
+   }
+   if(entry->next) {
+      entry->next->prev = entry->prev;
+   } else {
+      cacheTail = entry->prev;
+   }
+
+   cacheStats.entries -= 1;
+   cacheStats.bytes -= entry->size;
+
+}
+
+/** Release least recently used entries to make room for an entry. */
+void EvictCacheEntries(unsigned long size) {
+
+   CacheEntry *entry;
+   CacheEntry *prev;
+
+   entry = cacheTail;
+   while(entry && cacheStats.bytes + size > cacheStats.limit) {
+      prev = entry->prev;
+      if(!entry->locked) {
+         UnlinkCacheEntry(entry);
+         (entry->Release)(entry->object);
+         Release(entry);
+         cacheStats.evictions += 1;
+      }
+      entry = prev;
+   }
+
+}
+
+/** Get the approximate server memory used by a pixmap. */
+unsigned long GetPixmapSize(int width, int height, int depth) {
+
+   unsigned long pixels;
+
+   pixels = (unsigned long)width * height;
+   if(depth > 16) {
+      return pixels * 4;
+   } else if(depth > 8) {
+      return pixels * 2;
+   } else if(depth > 1) {
+      return pixels;
+   } else {
+      return (pixels + 7) / 8;
+   }
+
+}
+
+/** Get the cache counters. */
+void GetCacheStats(CacheStats *stats) {
+   *stats = cacheStats;
+}
+
+/** Set the size budget of the cache. */
+void SetCacheSize(const char *str) {
+
+   int size;
+
+   if(str) {
+      size = atoi(str);
+      if(JUNLIKELY(size < 0 || size > MAX_CACHE_SIZE)) {
+         Warning(_("invalid PixmapCacheSize: %d"), size);
+         size = DEFAULT_CACHE_SIZE;
+      }
+      cacheStats.limit = size * 1024UL;
+   }
+
+}
+
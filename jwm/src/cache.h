@@ -0,0 +1,100 @@
+/**
+ * @file cache.h
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Header for the pixmap cache.
+ *
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+/** Function to release the pixmaps of a cached object.
+ * The entry has already been removed from the cache when this is called.
+ */
+typedef void (*CacheReleaseFunc)(void *object);
+
+/** An object holding server pixmaps that can be recreated on demand. */
+typedef struct CacheEntry {
+
+   void *object;                 /**< The cached object. */
+   CacheReleaseFunc Release;     /**< Function to free the object. */
+   unsigned long size;           /**< Approximate size in bytes. */
+   int locked;                   /**< Lock count (locked entries stay). */
+
+   struct CacheEntry *prev;      /**< The next more recently used entry. */
+   struct CacheEntry *next;      /**< The next less recently used entry. */
+
+} CacheEntry;
+
+/** Cache counters for the statistics report. */
+typedef struct CacheStats {
+   unsigned long hits;           /**< Number of lookups that were cached. */
+   unsigned long misses;         /**< Number of entries created. */
+   unsigned long evictions;      /**< Number of entries evicted. */
+   unsigned long entries;        /**< Number of entries in the cache. */
+   unsigned long bytes;          /**< Current size in bytes. */
+   unsigned long peak;           /**< Largest size in bytes. */
+   unsigned long limit;          /**< Size budget in bytes. */
+} CacheStats;
+
+/*@{*/
+void InitializeCache();
+void StartupCache();
+void ShutdownCache();
+void DestroyCache();
+/*@}*/
+
+/** Add an object to the cache.
+ * Least recently used entries that are not locked are released first
+ * to make room, so the new entry is never evicted by this call.
+ * @param object The object.
+ * @param size The approximate size of the object in bytes.
+ * @param release Function to free the object if it is evicted.
+ * @return The cache entry for the object.
+ */
+CacheEntry *AddCacheEntry(void *object, unsigned long size,
+                          CacheReleaseFunc release);
+
+/** Mark a cached object as used.
+ * @param entry The cache entry.
+ */
+void TouchCacheEntry(CacheEntry *entry);
+
+/** Remove an object from the cache without releasing it.
+ * This is used when the owner frees the object itself.
+ * @param entry The cache entry (may be NULL).
+ */
+void RemoveCacheEntry(CacheEntry *entry);
+
+/** Prevent an object from being evicted.
+ * @param entry The cache entry.
+ */
+void LockCacheEntry(CacheEntry *entry);
+
+/** Allow an object to be evicted again.
+ * @param entry The cache entry.
+ */
+void UnlockCacheEntry(CacheEntry *entry);
+
+/** Get the approximate server memory used by a pixmap.
+ * @param width The width of the pixmap.
+ * @param height The height of the pixmap.
+ * @param depth The depth of the pixmap.
+ * @return The size in bytes.
+ */
+unsigned long GetPixmapSize(int width, int height, int depth);
+
+/** Get the cache counters.
+ * @param stats The structure to fill in.
+ */
+void GetCacheStats(CacheStats *stats);
+
+/** Set the size budget of the cache.
+ * @param str The size in kilobytes.
+ */
+void SetCacheSize(const char *str);
+
+#endif /* CACHE_H */
+
@@ -25,6 +25,7 @@
 #include "error.h"
 #include "place.h"
 #include "event.h"
+#include "control.h"
 
 static ClientNode *activeClient;
 
@@ -57,6 +58,7 @@ void InitializeClients() {
 void StartupClients() {
 
    XWindowAttributes attr;
+   AttributesRequest *requests;
    Window rootReturn, parentReturn, *childrenReturn;
    unsigned int childrenCount;
    unsigned int x;
@@ -75,9 +77,15 @@ void StartupClients() {
    JXQueryTree(display, rootWindow, &rootReturn, &parentReturn,
                &childrenReturn, &childrenCount);
 
+   /* Ask for the attributes of every window before waiting for any. */
+   requests = Allocate((childrenCount + 1) * sizeof(AttributesRequest));
+   for(x = 0; x < childrenCount; x++) {
+      JXRequestWindowAttributes(display, &requests[x], childrenReturn[x]);
+   }
+
    /* Add each client. */
    for(x = 0; x < childrenCount; x++) {
-      if(JXGetWindowAttributes(display, childrenReturn[x], &attr)) {
+      if(JXReceiveWindowAttributes(display, &requests[x], &attr)) {
          if(attr.override_redirect == False
             && attr.map_state == IsViewable) {
             AddClientWindow(childrenReturn[x], 1, 1);
@@ -85,6 +93,7 @@ void StartupClients() {
       }
    }
 
+   Release(requests);
    JXFree(childrenReturn);
 
    LoadFocus();
@@ -253,6 +262,8 @@ ClientNode *AddClientWindow(Window w, char alreadyMapped, char notOwner) {
 
    ReadClientStrut(np);
 
+   NotifyControl("add 0x%lx", (unsigned long)np->window);
+
    /* Focus transients if their parent has focus. */
    if(np->owner != None) {
       if(activeClient && np->owner == activeClient->window) {
@@ -840,6 +851,7 @@ void FocusClient(ClientNode *np) {
       DrawBorder(np, NULL);
       UpdatePager();
       UpdateTaskBar();
+      NotifyControl("focus 0x%lx", (unsigned long)np->window);
 
    }
 
@@ -1109,6 +1121,9 @@ void SetShape(ClientNode *np) {
 
    np->state.status |= STAT_SHAPE;
 
+   /* The shape set here replaces any rounded corners on the frame. */
+   ForgetRoundedRectWindow(np->parent);
+
    GetBorderSize(np, &north, &south, &east, &west);
 
    /* Shaded windows are a special case. */
@@ -1175,6 +1190,8 @@ void RemoveClient(ClientNode *np) {
 
    JXGrabServer(display);
 
+   NotifyControl("remove 0x%lx", (unsigned long)np->window);
+
    /* Remove this client from the client list */
    if(np->next) {
       np->next->prev = np->prev;
@@ -1200,6 +1217,7 @@ void RemoveClient(ClientNode *np) {
 
       SetWindowAtom(rootWindow, ATOM_NET_ACTIVE_WINDOW, None);
       activeClient = NULL;
+      NotifyControl("focus none");
 
       JXSetInputFocus(display, rootWindow, RevertToPointerRoot, eventTime);
 
@@ -1228,6 +1246,7 @@ void RemoveClient(ClientNode *np) {
 
    /* Destroy the parent */
    if(np->parent) {
+      ForgetRoundedRectWindow(np->parent);
       JXDestroyWindow(display, np->parent);
    }
 
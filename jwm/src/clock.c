@@ -315,7 +315,7 @@ void DrawClock(ClockType *clk, const TimeType *now, int x, int y) {
 
       /* Wrong size. Resize. */
       clk->cp->requestedWidth = rwidth;
-      ResizeTray(clk->cp->tray);
+      ResizeTrayComponent(clk->cp);
 
    }
 
@@ -18,6 +18,15 @@ typedef struct {
    const char *value;
 } DefaultColorNode;
 
+/** Named color resolved by the server (cached to avoid round trips). */
+typedef struct NamedColorNode {
+   char *name;
+   unsigned short red;
+   unsigned short green;
+   unsigned short blue;
+   struct NamedColorNode *next;
+} NamedColorNode;
+
 unsigned long colors[COLOR_COUNT];
 static unsigned long rgbColors[COLOR_COUNT];
 
@@ -82,6 +91,7 @@ static DefaultColorNode DEFAULT_COLORS[] = {
 };
 
 static char **names = NULL;
+static NamedColorNode *namedColors = NULL;
 
 static unsigned long redShift;
 static unsigned long greenShift;
@@ -120,6 +130,7 @@ void StartupColors() {
    int x;
    int red, green, blue;
    XColor c;
+   XColor *query;
 
    /* Determine how to convert between RGB triples and pixels. */
    Assert(rootVisual);
@@ -160,12 +171,16 @@ void StartupColors() {
 
       /* Compute the reverse pixel mapping (pixel -> 24-bit RGB). */
       rmap = Allocate(sizeof(unsigned long) * 256);
+      query = Allocate(sizeof(XColor) * 256);
+      for(x = 0; x < 256; x++) {
+         query[x].pixel = x;
+      }
+      JXQueryColors(display, rootColormap, query, 256);
       for(x = 0; x < 256; x++) {
-         c.pixel = x;
-         JXQueryColor(display, rootColormap, &c);
-         GetDirectPixel(&c);
-         rmap[x] = c.pixel;
+         GetDirectPixel(&query[x]);
+         rmap[x] = query[x].pixel;
       }
+      Release(query);
 
       break;
    }
@@ -241,9 +256,19 @@ void StartupColors() {
 /** Shutdown color support. */
 void ShutdownColors() {
 
+   NamedColorNode *np;
 #ifdef USE_XFT
-
    int x;
+#endif
+
+   while(namedColors) {
+      np = namedColors->next;
+      Release(namedColors->name);
+      Release(namedColors);
+      namedColors = np;
+   }
+
+#ifdef USE_XFT
 
    for(x = 0; x < COLOR_COUNT; x++) {
       if(xftColors[x]) {
@@ -511,16 +536,39 @@ void DarkenColor(ColorType oldColor, ColorType newColor) {
 
 }
 
-/** Look up a color by name. */
+/** Look up a color by name.
+ * Names are resolved by the server once and then cached.
+ */
 int GetColorByName(const char *str, XColor *c) {
 
+   NamedColorNode *np;
+
    Assert(str);
    Assert(c);
 
+   for(np = namedColors; np; np = np->next) {
+      if(!strcmp(np->name, str)) {
+         c->red = np->red;
+         c->green = np->green;
+         c->blue = np->blue;
+         c->flags = DoRed | DoGreen | DoBlue;
+         GetColor(c);
+         return 1;
+      }
+   }
+
    if(!JXParseColor(display, rootColormap, str, c)) {
       return 0;
    }
 
+   np = Allocate(sizeof(NamedColorNode));
+   np->name = CopyString(str);
+   np->red = c->red;
+   np->green = c->green;
+   np->blue = c->blue;
+   np->next = namedColors;
+   namedColors = np;
+
    GetColor(c);
 
    return 1;
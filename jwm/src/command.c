@@ -12,20 +12,46 @@
 #include "misc.h"
 #include "main.h"
 #include "error.h"
+#include "stats.h"
 
 /** Structure to represent a list of commands. */
 typedef struct CommandNode {
    char *command;             /**< The command. */
+   char *after;               /**< Swallowed program to wait for. */
    struct CommandNode *next;  /**< The next command in the list. */
 } CommandNode;
 
+/** Characters that require a command to be run by the shell. */
+static const char *SHELL_CHARACTERS = "|&;<>()$`\\\"'*?[]#~=%{}!\n";
+
+#ifdef HAVE_SPAWN_H
+/** Shell builtins and keywords that cannot be run as programs. */
+static const char *SHELL_WORDS[] = {
+   ".",        "alias",    "bg",       "break",    "case",
+   "cd",       "command",  "continue", "do",       "done",
+   "elif",     "else",     "esac",     "eval",     "exec",
+   "exit",     "export",   "fc",       "fg",       "fi",
+   "for",      "function", "getopts",  "hash",     "if",
+   "jobs",     "read",     "readonly", "return",   "select",
+   "set",      "shift",    "source",   "then",     "time",
+   "times",    "trap",     "type",     "ulimit",   "umask",
+   "unalias",  "unset",    "until",    "wait",     "while"
+};
+#define SHELL_WORD_COUNT (sizeof(SHELL_WORDS) / sizeof(SHELL_WORDS[0]))
+#endif
+
 static CommandNode *startupCommands;
 static CommandNode *shutdownCommands;
 static CommandNode *restartCommands;
 
 static void RunCommands(CommandNode *commands);
+static void SetDisplayEnvironment();
+#ifdef HAVE_SPAWN_H
+static int SpawnCommand(const char *command);
+static char IsShellWord(const char *word);
+#endif
 static void ReleaseCommands(CommandNode **commands);
-static void AddCommand(CommandNode **commands, const char *command);
+static CommandNode *AddCommand(CommandNode **commands, const char *command);
 
 /** Initialize the command lists. */
 void InitializeCommands() {
@@ -37,6 +63,11 @@ void InitializeCommands() {
 /** Process startup/restart commands. */
 void StartupCommands() {
 
+#ifdef HAVE_FCNTL_H
+   /* Programs we start should not inherit the X connection. */
+   fcntl(JXConnectionNumber(display), F_SETFD, FD_CLOEXEC);
+#endif
+
    if(isRestarting) {
       RunCommands(restartCommands);
    } else {
@@ -67,7 +98,31 @@ void RunCommands(CommandNode *commands) {
    CommandNode *cp;
 
    for(cp = commands; cp; cp = cp->next) {
-      RunCommand(cp->command);
+      if(!cp->after) {
+         RunCommand(cp->command);
+      }
+   }
+
+}
+
+/** Run startup commands that were waiting for a swallowed program.
+ * Each waiting command is run once, when the program it names is
+ * swallowed or when JWM stops waiting for swallowed programs.
+ */
+void RunWaitingCommands(const char *name) {
+
+   CommandNode *cp;
+
+   if(isRestarting) {
+      return;
+   }
+
+   for(cp = startupCommands; cp; cp = cp->next) {
+      if(cp->after && (!name || !strcmp(cp->after, name))) {
+         RunCommand(cp->command);
+         Release(cp->after);
+         cp->after = NULL;
+      }
    }
 
 }
@@ -82,6 +137,9 @@ void ReleaseCommands(CommandNode **commands) {
    while(*commands) {
       cp = (*commands)->next;
       Release((*commands)->command);
+      if((*commands)->after) {
+         Release((*commands)->after);
+      }
       Release(*commands);
       *commands = cp;
    }
@@ -89,14 +147,14 @@ void ReleaseCommands(CommandNode **commands) {
 }
 
 /** Add a command to a command list. */
-void AddCommand(CommandNode **commands, const char *command) {
+CommandNode *AddCommand(CommandNode **commands, const char *command) {
 
    CommandNode *cp;
 
    Assert(commands);
 
    if(!command) {
-      return;
+      return NULL;
    }
 
    cp = Allocate(sizeof(CommandNode));
@@ -104,12 +162,22 @@ void AddCommand(CommandNode **commands, const char *command) {
    *commands = cp;
 
    cp->command = CopyString(command);
+   cp->after = NULL;
+
+   return cp;
 
 }
 
 /** Add a startup command. */
-void AddStartupCommand(const char *command) {
-   AddCommand(&startupCommands, command);
+void AddStartupCommand(const char *command, const char *after) {
+
+   CommandNode *cp;
+
+   cp = AddCommand(&startupCommands, command);
+   if(cp && after && after[0]) {
+      cp->after = CopyString(after);
+   }
+
 }
 
 /** Add a shutdown command. */
@@ -122,30 +190,149 @@ void AddRestartCommand(const char *command) {
    AddCommand(&restartCommands, command);
 }
 
+/** Release the shutdown and restart commands. */
+void ReleaseExitCommands() {
+   ReleaseCommands(&shutdownCommands);
+   ReleaseCommands(&restartCommands);
+}
+
+/** Set DISPLAY for the programs we start.
+ * This is only done once since the display does not change.
+ */
+void SetDisplayEnvironment() {
+
+   static char *displayEnv = NULL;
+   const char *displayString;
+
+   displayString = DisplayString(display);
+   if(!displayEnv && displayString && displayString[0]) {
+      displayEnv = malloc(strlen(displayString) + 9);
+      sprintf(displayEnv, "DISPLAY=%s", displayString);
+      putenv(displayEnv);
+   }
+
+}
+
+#ifdef HAVE_SPAWN_H
+
+/** Determine if a word is a shell builtin or keyword. */
+char IsShellWord(const char *word) {
+   unsigned int x;
+   for(x = 0; x < SHELL_WORD_COUNT; x++) {
+      if(!strcmp(word, SHELL_WORDS[x])) {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+/** Start a program without copying the JWM process.
+ * Commands without shell syntax are run directly, others are run with
+ * the shell. The shell is also used when the first word is a shell
+ * builtin or is not found in the PATH, so the shell can run or report
+ * it. Children are reaped by the kernel (SA_NOCLDWAIT).
+ * @return 1 if the program was started, 0 otherwise.
+ */
+int SpawnCommand(const char *command) {
+
+   extern char **environ;
+
+   posix_spawnattr_t attr;
+   char *shellArgv[4];
+   char *buffer;
+   char **argv;
+   const char *program;
+   int argc;
+   int x;
+   int status;
+   short flags;
+
+   /* Split simple commands into arguments. */
+   argc = 0;
+   argv = NULL;
+   buffer = NULL;
+   if(!strpbrk(command, SHELL_CHARACTERS)) {
+      buffer = CopyString(command);
+      argv = Allocate(sizeof(char*) * (strlen(buffer) / 2 + 2));
+      for(x = 0; buffer[x]; x++) {
+         if(buffer[x] == ' ' || buffer[x] == '\t') {
+            buffer[x] = 0;
+         } else if(x == 0 || buffer[x - 1] == 0) {
+            argv[argc++] = &buffer[x];
+         }
+      }
+      argv[argc] = NULL;
+   }
+
+   posix_spawnattr_init(&attr);
+#ifdef POSIX_SPAWN_SETSID
+   flags = POSIX_SPAWN_SETSID;
+#else
+   flags = POSIX_SPAWN_SETPGROUP;
+   posix_spawnattr_setpgroup(&attr, 0);
+#endif
+   posix_spawnattr_setflags(&attr, flags);
+
+   status = ENOENT;
+   if(argc > 0 && !IsShellWord(argv[0])) {
+      program = argv[0];
+      status = posix_spawnp(NULL, program, NULL, &attr, argv, environ);
+   }
+   if(status == ENOENT) {
+      shellArgv[0] = SHELL_NAME;
+      shellArgv[1] = "-c";
+      shellArgv[2] = (char*)command;
+      shellArgv[3] = NULL;
+      program = SHELL_NAME;
+      status = posix_spawn(NULL, program, NULL, &attr, shellArgv, environ);
+   }
+
+   posix_spawnattr_destroy(&attr);
+
+   if(JUNLIKELY(status != 0)) {
+      Warning(_("exec failed: (%s) %s"), program, command);
+   }
+
+   if(buffer) {
+      Release(argv);
+      Release(buffer);
+   }
+
+   return status == 0;
+
+}
+
+#endif /* HAVE_SPAWN_H */
+
 /** Execute an external program. */
 void RunCommand(const char *command) {
 
-   const char *displayString;
-   char *str;
+   ProfileTime start;
 
    if(JUNLIKELY(!command)) {
       return;
    }
 
-   displayString = DisplayString(display);
+   SetDisplayEnvironment();
+   start = StartProfile();
+
+#ifdef HAVE_SPAWN_H
+
+   SpawnCommand(command);
+
+#else
 
    if(!fork()) {
       close(ConnectionNumber(display));
-      if(displayString && displayString[0]) {
-         str = malloc(strlen(displayString) + 9);
-         sprintf(str, "DISPLAY=%s", displayString);
-         putenv(str);
-      }
       setsid();
       execl(SHELL_NAME, SHELL_NAME, "-c", command, NULL);
       Warning(_("exec failed: (%s) %s"), SHELL_NAME, command);
       exit(EXIT_SUCCESS);
    }
 
+#endif
+
+   StopProfile(PROFILE_RUN_COMMAND, start);
+
 }
 
@@ -19,8 +19,15 @@ void DestroyCommands();
 
 /** Add a command to be executed at startup.
  * @param command The command to execute.
+ * @param after The swallowed program to wait for (NULL to run at once).
  */
-void AddStartupCommand(const char *command);
+void AddStartupCommand(const char *command, const char *after);
+
+/** Run startup commands that were waiting for a swallowed program.
+ * @param name The name of the swallowed program that is ready or NULL
+ * to run all waiting commands.
+ */
+void RunWaitingCommands(const char *name);
 
 /** Add a command to be executed at shutdown.
  * @param command The command to execute.
@@ -32,6 +39,11 @@ void AddShutdownCommand(const char *command);
  */
 void AddRestartCommand(const char *command);
 
+/** Release the shutdown and restart commands before they are reloaded.
+ * Startup commands are kept since they are only used at startup.
+ */
+void ReleaseExitCommands();
+
 /** Run a command.
  * @param command The command to run (run in sh).
  */
@@ -16,6 +16,7 @@
 #include "screen.h"
 #include "color.h"
 #include "misc.h"
+#include "event.h"
 
 #ifndef DISABLE_CONFIRM
 
@@ -62,10 +63,11 @@ static void DestroyConfirmDialog(DialogType *d);
 static void ComputeDimensions(DialogType *d);
 static void DrawMessage(DialogType *d);
 static void DrawButtons(DialogType *d);
-static DialogType *FindDialogByWindow(Window w);
-static int HandleDialogExpose(const XExposeEvent *event); 
-static int HandleDialogButtonPress(const XButtonEvent *event);
-static int HandleDialogButtonRelease(const XButtonEvent *event);
+static int ProcessDialogEvent(const XEvent *event, void *data);
+static void HandleDialogButtonPress(DialogType *dp,
+                                    const XButtonEvent *event);
+static void HandleDialogButtonRelease(DialogType *dp,
+                                      const XButtonEvent *event);
 
 /** Initialize the dialog processing data. */
 void InitializeDialogs() {
@@ -89,155 +91,111 @@ void DestroyDialogs() {
 }
 
 /** Handle an event on a dialog window. */
-int ProcessDialogEvent(const XEvent *event) {
+int ProcessDialogEvent(const XEvent *event, void *data) {
 
-   int handled = 0;
+   DialogType *dp = (DialogType*)data;
 
    Assert(event);
+   Assert(dp);
 
    switch(event->type) {
    case Expose:
-      return HandleDialogExpose(&event->xexpose);
+      DrawConfirmDialog(dp);
+      return 1;
    case ButtonPress:
-      return HandleDialogButtonPress(&event->xbutton);
+      HandleDialogButtonPress(dp, &event->xbutton);
+      return 1;
    case ButtonRelease:
-      return HandleDialogButtonRelease(&event->xbutton);
+      HandleDialogButtonRelease(dp, &event->xbutton);
+      return 1;
    default:
-      break;
+      return 0;
    }
 
-   return handled;
-
 }
 
-/** Handle an expose event. */
-int HandleDialogExpose(const XExposeEvent *event) {
+/** Release the pressed buttons of all dialogs.
+ * This is called when a button is released outside of the dialogs.
+ */
+void ResetDialogButtons() {
 
    DialogType *dp;
 
-   Assert(event);
-
-   dp = FindDialogByWindow(event->window);
-   if(dp) {
-      DrawConfirmDialog(dp);
-      return 1;
-   } else {
-      return 0;
+   for(dp = dialogList; dp; dp = dp->next) {
+      if(dp->buttonState != DBS_NORMAL) {
+         dp->buttonState = DBS_NORMAL;
+         DrawButtons(dp);
+      }
    }
+
 }
 
 /** Handle a mouse button release event. */
-int HandleDialogButtonRelease(const XButtonEvent *event) {
+void HandleDialogButtonRelease(DialogType *dp, const XButtonEvent *event) {
 
-   DialogType *dp;
    int x, y;
    int cancelPressed, okPressed;
 
    Assert(event);
 
-   dp = FindDialogByWindow(event->window);
-   if(dp) {
-      cancelPressed = 0;
-      okPressed = 0;
-      y = event->y;
-      if(y >= dp->buttony && y < dp->buttony + dp->buttonHeight) {
-         x = event->x;
-         if(x >= dp->okx && x < dp->okx + dp->buttonWidth) {
-            okPressed = 1;
-         } else if(x >= dp->cancelx && x < dp->cancelx + dp->buttonWidth) {
-            cancelPressed = 1;
-         }
-      }
-
-      if(okPressed) {
-         (dp->action)(dp->client);
+   cancelPressed = 0;
+   okPressed = 0;
+   y = event->y;
+   if(y >= dp->buttony && y < dp->buttony + dp->buttonHeight) {
+      x = event->x;
+      if(x >= dp->okx && x < dp->okx + dp->buttonWidth) {
+         okPressed = 1;
+      } else if(x >= dp->cancelx && x < dp->cancelx + dp->buttonWidth) {
+         cancelPressed = 1;
       }
+   }
 
-      if(cancelPressed || okPressed) {
-         DestroyConfirmDialog(dp);
-      } else {
-         dp->buttonState = DBS_NORMAL;
-         DrawButtons(dp);
-      }
+   if(okPressed) {
+      (dp->action)(dp->client);
+   }
 
-      return 1;
+   if(cancelPressed || okPressed) {
+      DestroyConfirmDialog(dp);
    } else {
-
-      for(dp = dialogList; dp; dp = dp->next) {
-         if(dp->buttonState != DBS_NORMAL) {
-            dp->buttonState = DBS_NORMAL;
-            DrawButtons(dp);
-         }
-      }
-
-      return 0;
-
+      dp->buttonState = DBS_NORMAL;
+      DrawButtons(dp);
    }
 
 }
 
-/** Handle a mouse button release event. */
-int HandleDialogButtonPress(const XButtonEvent *event) {
+/** Handle a mouse button press event. */
+void HandleDialogButtonPress(DialogType *dp, const XButtonEvent *event) {
 
-   DialogType *dp;
    int cancelPressed;
    int okPressed;
    int x, y;
 
    Assert(event);
 
-   /* Find the dialog on which the press occured (if any). */
-   dp = FindDialogByWindow(event->window);
-   if(dp) {
-
-      /* Determine which button was pressed (if any). */
-      cancelPressed = 0;
-      okPressed = 0;
-      y = event->y;
-      if(y >= dp->buttony && y < dp->buttony + dp->buttonHeight) {
-         x = event->x;
-         if(x >= dp->okx && x < dp->okx + dp->buttonWidth) {
-            okPressed = 1;
-         } else if(x >= dp->cancelx && x < dp->cancelx + dp->buttonWidth) {
-            cancelPressed = 1;
-         }
+   /* Determine which button was pressed (if any). */
+   cancelPressed = 0;
+   okPressed = 0;
+   y = event->y;
+   if(y >= dp->buttony && y < dp->buttony + dp->buttonHeight) {
+      x = event->x;
+      if(x >= dp->okx && x < dp->okx + dp->buttonWidth) {
+         okPressed = 1;
+      } else if(x >= dp->cancelx && x < dp->cancelx + dp->buttonWidth) {
+         cancelPressed = 1;
       }
-
-      dp->buttonState = DBS_NORMAL;
-      if(cancelPressed) {
-         dp->buttonState = DBS_CANCEL;
-      }
-
-      if(okPressed) {
-         dp->buttonState = DBS_OK;
-      }
-
-      /* Draw the buttons. */
-      DrawButtons(dp);
-
-      return 1;
-
-   } else {
-
-      /* This event doesn't affect us. */
-      return 0;
-
    }
 
-}
-
-/** Find a dialog by window or frame. */
-DialogType *FindDialogByWindow(Window w) {
-
-   DialogType *dp;
+   dp->buttonState = DBS_NORMAL;
+   if(cancelPressed) {
+      dp->buttonState = DBS_CANCEL;
+   }
 
-   for(dp = dialogList; dp; dp = dp->next) {
-      if(dp->node->window == w) {
-         return dp;
-      }
+   if(okPressed) {
+      dp->buttonState = DBS_OK;
    }
 
-   return NULL;
+   /* Draw the buttons. */
+   DrawButtons(dp);
 
 }
 
@@ -303,6 +261,7 @@ void ShowConfirmDialog(ClientNode *np, void (*action)(ClientNode*), ...) {
    }
    dp->node->state.status |= STAT_WMDIALOG;
    FocusClient(dp->node);
+   RegisterEventHandler(window, ProcessDialogEvent, dp);
 
    DrawConfirmDialog(dp);
 
@@ -330,6 +289,8 @@ void DestroyConfirmDialog(DialogType *dp) {
 
    /* This will take care of destroying the dialog window since
     * its parent will be destroyed. */
+   UnregisterEventHandler(dp->node->window);
+   UntrackResource(RESOURCE_WINDOW, dp->node->window);
    RemoveClient(dp->node);
 
    for(x = 0; x < dp->lineCount; x++) {
@@ -476,9 +437,8 @@ void DrawButtons(DialogType *dp) {
 
 #else /* DISABLE_CONFIRM */
 
-/** Process an event on a dialog window. */
-int ProcessDialogEvent(const XEvent *event) {
-   return 0;
+/** Release the pressed buttons of all dialogs. */
+void ResetDialogButtons() {
 }
 
 /** Show a confirm dialog. */
@@ -19,12 +19,6 @@ void ShutdownDialogs();
 void DestroyDialogs();
 /*@}*/
 
-/** Handle an event on a dialog window.
- * @param event The event.
- * @return 1 if handled, 0 if not handled.
- */
-int ProcessDialogEvent(const XEvent *event);
-
 /** Show a confirm dialog.
  * @param np A client window associated with the dialog.
  * @param action A callback to run if "OK" is clicked.
@@ -32,5 +26,10 @@ int ProcessDialogEvent(const XEvent *event);
 void ShowConfirmDialog(struct ClientNode *np,
    void (*action)(struct ClientNode*), ...);
 
+/** Release the pressed buttons of all dialogs.
+ * This is called when a button is released outside of the dialogs.
+ */
+void ResetDialogButtons();
+
 #endif /* CONFIRM_H */
 
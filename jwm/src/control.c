@@ -0,0 +1,598 @@
+/**
+ * @file control.c
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Control socket.
+ *
+ * Scripts connect to a unix socket and send one command per line.
+ * The output of each command is followed by a line containing "ok" or
+ * "error" and a message, so several commands can be sent at once.
+ * After "subscribe", a client also receives a line starting with
+ * "event" whenever the focus, the desktop, or the client list changes.
+ *
+ */
+
+/* Needed for struct ucred with glibc. */
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+#endif
+
+#include "jwm.h"
+#include "control.h"
+#include "main.h"
+#include "client.h"
+#include "clientlist.h"
+#include "desktop.h"
+#include "tray.h"
+#include "root.h"
+#include "error.h"
+#include "misc.h"
+
+#ifdef USE_CONTROL
+
+#ifndef MSG_NOSIGNAL
+#  define MSG_NOSIGNAL 0
+#endif
+
+/** Size of the input buffer for each control client. */
+#define CONTROL_BUFFER_SIZE 1024
+
+/** Maximum number of control clients. */
+#define MAX_CONTROL_CLIENTS 32
+
+/** A connection to the control socket. */
+typedef struct ControlClient {
+   int fd;                          /**< Connection or -1 if closed. */
+   char subscribed;                 /**< Set to stream events. */
+   int length;                      /**< Bytes in the buffer. */
+   char buffer[CONTROL_BUFFER_SIZE];
+   struct ControlClient *next;
+} ControlClient;
+
+static int controlSocket = -1;
+static char *socketPath = NULL;
+static ControlClient *controlClients = NULL;
+static int controlClientCount = 0;
+
+static void AcceptControlClient();
+static int IsSameUser(int fd);
+static void ReadControlClient(ControlClient *cp);
+static void RunControlCommand(ControlClient *cp, char *line);
+static void WriteControl(ControlClient *cp, const char *format, ...);
+static const char *EscapeName(const char *name, char *buffer, size_t size);
+static void WriteClients(ControlClient *cp);
+static void WriteDesktops(ControlClient *cp);
+static void WriteFocus(ControlClient *cp);
+static void WriteTrays(ControlClient *cp);
+static void RemoveClosedClients();
+static void SetNonBlocking(int fd);
+
+/** Initialize control socket data. */
+void InitializeControl() {
+   controlSocket = -1;
+   socketPath = NULL;
+   controlClients = NULL;
+   controlClientCount = 0;
+}
+
+/** Create the control socket.
+ * The socket is $JWM_SOCKET if set. Otherwise it is jwm-DISPLAY in
+ * $XDG_RUNTIME_DIR, or jwm-UID-DISPLAY in /tmp.
+ */
+void StartupControl() {
+
+   struct sockaddr_un addr;
+   const char *name;
+   const char *dir;
+   size_t length;
+   mode_t mask;
+   int result;
+
+   name = getenv("JWM_SOCKET");
+   if(name) {
+      socketPath = CopyString(name);
+   } else {
+      name = DisplayString(display);
+      dir = getenv("XDG_RUNTIME_DIR");
+      length = strlen(name) + 32;
+      if(dir) {
+         socketPath = Allocate(strlen(dir) + length);
+         sprintf(socketPath, "%s/jwm-%s", dir, name);
+      } else {
+         socketPath = Allocate(length + 5);
+         sprintf(socketPath, "/tmp/jwm-%u-%s", (unsigned int)getuid(), name);
+      }
+   }
+
+   if(JUNLIKELY(strlen(socketPath) >= sizeof(addr.sun_path))) {
+      Warning(_("control socket path too long: %s"), socketPath);
+      Release(socketPath);
+      socketPath = NULL;
+      return;
+   }
+
+   controlSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+   if(JUNLIKELY(controlSocket < 0)) {
+      Warning(_("could not create control socket"));
+      Release(socketPath);
+      socketPath = NULL;
+      return;
+   }
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, socketPath);
+
+   /* Remove a socket left behind by a previous instance. */
+   unlink(socketPath);
+
+   /* Only the user may connect. Connections are also checked in
+    * AcceptControlClient where the system supports it. */
+   mask = umask(077);
+   result = bind(controlSocket, (struct sockaddr*)&addr, sizeof(addr));
+   umask(mask);
+   if(JUNLIKELY(result < 0 || chmod(socketPath, 0600) < 0
+             || listen(controlSocket, 4) < 0)) {
+      Warning(_("could not bind control socket %s"), socketPath);
+      close(controlSocket);
+      controlSocket = -1;
+      Release(socketPath);
+      socketPath = NULL;
+      return;
+   }
+
+   SetNonBlocking(controlSocket);
+
+}
+
+/** Close the control socket and all connections. */
+void ShutdownControl() {
+
+   ControlClient *cp;
+
+   while(controlClients) {
+      cp = controlClients->next;
+      if(controlClients->fd >= 0) {
+         close(controlClients->fd);
+      }
+      Release(controlClients);
+      controlClients = cp;
+   }
+   controlClientCount = 0;
+
+   if(controlSocket >= 0) {
+      close(controlSocket);
+      controlSocket = -1;
+   }
+   if(socketPath) {
+      unlink(socketPath);
+      Release(socketPath);
+      socketPath = NULL;
+   }
+
+}
+
+/** Destroy control socket data. */
+void DestroyControl() {
+}
+
+/** Add the control socket descriptors to a select set. */
+int AddControlDescriptors(fd_set *fds, int maxfd) {
+
+   ControlClient *cp;
+
+   if(controlSocket >= 0) {
+      FD_SET(controlSocket, fds);
+      if(controlSocket > maxfd) {
+         maxfd = controlSocket;
+      }
+   }
+   for(cp = controlClients; cp; cp = cp->next) {
+      if(cp->fd >= 0) {
+         FD_SET(cp->fd, fds);
+         if(cp->fd > maxfd) {
+            maxfd = cp->fd;
+         }
+      }
+   }
+
+   return maxfd;
+
+}
+
+/** Handle activity on the control socket descriptors. */
+void ProcessControl(const fd_set *fds) {
+
+   ControlClient *cp;
+
+   for(cp = controlClients; cp; cp = cp->next) {
+      if(cp->fd >= 0 && FD_ISSET(cp->fd, fds)) {
+         ReadControlClient(cp);
+      }
+   }
+
+   if(controlSocket >= 0 && FD_ISSET(controlSocket, fds)) {
+      AcceptControlClient();
+   }
+
+   RemoveClosedClients();
+
+}
+
+/** Send an event line to control clients that subscribed. */
+void NotifyControl(const char *format, ...) {
+
+   ControlClient *cp;
+   char line[CONTROL_BUFFER_SIZE];
+   va_list ap;
+
+   for(cp = controlClients; cp; cp = cp->next) {
+      if(cp->subscribed) {
+         break;
+      }
+   }
+   if(JLIKELY(!cp)) {
+      return;
+   }
+
+   va_start(ap, format);
+   vsnprintf(line, sizeof(line), format, ap);
+   va_end(ap);
+
+   for(cp = controlClients; cp; cp = cp->next) {
+      if(cp->subscribed) {
+         WriteControl(cp, "event %s\n", line);
+      }
+   }
+
+}
+
+/** Accept a new connection. */
+void AcceptControlClient() {
+
+   ControlClient *cp;
+   int fd;
+
+   fd = accept(controlSocket, NULL, NULL);
+   if(fd < 0) {
+      return;
+   }
+   if(JUNLIKELY(controlClientCount >= MAX_CONTROL_CLIENTS
+             || !IsSameUser(fd))) {
+      close(fd);
+      return;
+   }
+
+   SetNonBlocking(fd);
+
+   cp = Allocate(sizeof(ControlClient));
+   cp->fd = fd;
+   cp->subscribed = 0;
+   cp->length = 0;
+   cp->next = controlClients;
+   controlClients = cp;
+   controlClientCount += 1;
+
+}
+
+/** Determine if a connection is from the user running jwm. */
+int IsSameUser(int fd) {
+
+#if defined(HAVE_GETPEEREID)
+
+   uid_t uid;
+   gid_t gid;
+
+   if(JUNLIKELY(getpeereid(fd, &uid, &gid) < 0)) {
+      return 0;
+   }
+   return uid == getuid();
+
+#elif defined(SO_PEERCRED)
+
+   struct ucred cred;
+   socklen_t length;
+
+   length = sizeof(cred);
+   if(JUNLIKELY(getsockopt(fd, SOL_SOCKET, SO_PEERCRED,
+                           &cred, &length) < 0)) {
+      return 0;
+   }
+   return cred.uid == getuid();
+
+#else
+
+   /* Rely on the permissions of the socket. */
+   return 1;
+
+#endif
+
+}
+
+/** Read and run the commands available from a connection. */
+void ReadControlClient(ControlClient *cp) {
+
+   char *line;
+   char *end;
+   int count;
+
+   count = read(cp->fd, &cp->buffer[cp->length],
+                CONTROL_BUFFER_SIZE - cp->length);
+   if(count <= 0) {
+      close(cp->fd);
+      cp->fd = -1;
+      return;
+   }
+   cp->length += count;
+
+   /* Run each complete line. */
+   line = cp->buffer;
+   for(;;) {
+      end = memchr(line, '\n', cp->length - (line - cp->buffer));
+      if(!end) {
+         break;
+      }
+      *end = 0;
+      RunControlCommand(cp, line);
+      line = end + 1;
+      if(cp->fd < 0) {
+         return;
+      }
+   }
+
+   cp->length -= line - cp->buffer;
+   memmove(cp->buffer, line, cp->length);
+
+   if(JUNLIKELY(cp->length == CONTROL_BUFFER_SIZE)) {
+      WriteControl(cp, "error line too long\n");
+      close(cp->fd);
+      cp->fd = -1;
+   }
+
+}
+
+/** Run a control command. */
+void RunControlCommand(ControlClient *cp, char *line) {
+
+   char *command;
+   char *arg;
+
+   command = line;
+   while(*command == ' ' || *command == '\t') {
+      ++command;
+   }
+   arg = command;
+   while(*arg && *arg != ' ' && *arg != '\t' && *arg != '\r') {
+      ++arg;
+   }
+   if(*arg) {
+      *arg++ = 0;
+      while(*arg == ' ' || *arg == '\t') {
+         ++arg;
+      }
+   }
+
+   if(!strcmp(command, "clients")) {
+      WriteClients(cp);
+   } else if(!strcmp(command, "desktops")) {
+      WriteDesktops(cp);
+   } else if(!strcmp(command, "focus")) {
+      WriteFocus(cp);
+   } else if(!strcmp(command, "trays")) {
+      WriteTrays(cp);
+   } else if(!strcmp(command, "desktop") && *arg) {
+      ChangeDesktop((unsigned int)atoi(arg));
+   } else if(!strcmp(command, "subscribe")) {
+      cp->subscribed = 1;
+   } else if(!strcmp(command, "unsubscribe")) {
+      cp->subscribed = 0;
+   } else if(!strcmp(command, "reload")) {
+      ReloadMenu();
+   } else if(!strcmp(command, "restart")) {
+      Restart();
+   } else if(!strcmp(command, "exit")) {
+      Exit();
+   } else if(command[0] == 0) {
+      return;
+   } else {
+      WriteControl(cp, "error unknown command: %s\n", command);
+      return;
+   }
+
+   WriteControl(cp, "ok\n");
+
+}
+
+/** Write to a connection, closing it if the write fails. */
+void WriteControl(ControlClient *cp, const char *format, ...) {
+
+   char line[CONTROL_BUFFER_SIZE];
+   va_list ap;
+   int length;
+
+   if(cp->fd < 0) {
+      return;
+   }
+
+   va_start(ap, format);
+   length = vsnprintf(line, sizeof(line), format, ap);
+   va_end(ap);
+   if(length >= sizeof(line)) {
+      length = sizeof(line) - 1;
+      line[length - 1] = '\n';
+   }
+
+   /* Clients that do not keep up are dropped rather than blocking. */
+   if(send(cp->fd, line, length, MSG_NOSIGNAL) != length) {
+      close(cp->fd);
+      cp->fd = -1;
+   }
+
+}
+
+/** Escape a name so that it stays on one line.
+ * Backslashes and line breaks are written as \\, \n and \r.
+ * Names that do not fit in the buffer are truncated.
+ */
+const char *EscapeName(const char *name, char *buffer, size_t size) {
+
+   size_t length;
+   char c;
+
+   length = 0;
+   if(name) {
+      for(; *name && length + 2 < size; name++) {
+         switch(*name) {
+         case '\\':
+            c = '\\';
+            break;
+         case '\n':
+            c = 'n';
+            break;
+         case '\r':
+            c = 'r';
+            break;
+         default:
+            buffer[length++] = *name;
+            continue;
+         }
+         buffer[length++] = '\\';
+         buffer[length++] = c;
+      }
+   }
+   buffer[length] = 0;
+   return buffer;
+
+}
+
+/** Write the client list, from the top layer down. */
+void WriteClients(ControlClient *cp) {
+
+   ClientNode *np;
+   char name[CONTROL_BUFFER_SIZE / 2];
+   unsigned int status;
+   int layer;
+
+   for(layer = LAYER_COUNT - 1; layer >= 0; layer--) {
+      for(np = nodes[layer]; np; np = np->next) {
+         status = np->state.status;
+         WriteControl(cp, "client window=0x%lx desktop=%u layer=%d "
+                      "x=%d y=%d width=%d height=%d "
+                      "active=%d minimized=%d shaded=%d sticky=%d "
+                      "name=%s\n",
+                      (unsigned long)np->window, np->state.desktop, layer,
+                      np->x, np->y, np->width, np->height,
+                      (status & STAT_ACTIVE) ? 1 : 0,
+                      (status & STAT_MINIMIZED) ? 1 : 0,
+                      (status & STAT_SHADED) ? 1 : 0,
+                      (status & STAT_STICKY) ? 1 : 0,
+                      EscapeName(np->name, name, sizeof(name)));
+      }
+   }
+
+}
+
+/** Write the desktop list. */
+void WriteDesktops(ControlClient *cp) {
+
+   char name[CONTROL_BUFFER_SIZE / 2];
+   unsigned int x;
+
+   for(x = 0; x < desktopCount; x++) {
+      WriteControl(cp, "desktop index=%u current=%d name=%s\n",
+                   x, x == currentDesktop ? 1 : 0,
+                   EscapeName(GetDesktopName(x), name, sizeof(name)));
+   }
+
+}
+
+/** Write the active window. */
+void WriteFocus(ControlClient *cp) {
+
+   ClientNode *np;
+
+   np = GetActiveClient();
+   if(np) {
+      WriteControl(cp, "focus window=0x%lx\n", (unsigned long)np->window);
+   } else {
+      WriteControl(cp, "focus window=none\n");
+   }
+
+}
+
+/** Write the state of each tray. */
+void WriteTrays(ControlClient *cp) {
+
+   TrayType *tp;
+
+   for(tp = GetTrays(); tp; tp = tp->next) {
+      WriteControl(cp, "tray window=0x%lx x=%d y=%d width=%d height=%d "
+                   "autohide=%d hidden=%d\n",
+                   (unsigned long)tp->window, tp->x, tp->y,
+                   tp->width, tp->height, tp->autoHide, tp->hidden);
+   }
+
+}
+
+/** Free connections that have been closed. */
+void RemoveClosedClients() {
+
+   ControlClient **cpp;
+   ControlClient *cp;
+
+   cpp = &controlClients;
+   while(*cpp) {
+      cp = *cpp;
+      if(cp->fd < 0) {
+         *cpp = cp->next;
+         Release(cp);
+         controlClientCount -= 1;
+      } else {
+         cpp = &cp->next;
+      }
+   }
+
+}
+
+/** Make a descriptor non-blocking and close it on exec. */
+void SetNonBlocking(int fd) {
+#ifdef HAVE_FCNTL_H
+   fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+   fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+}
+
+#else /* USE_CONTROL */
+
+/** Initialize control socket data. */
+void InitializeControl() {
+}
+
+/** Create the control socket. */
+void StartupControl() {
+}
+
+/** Close the control socket. */
+void ShutdownControl() {
+}
+
+/** Destroy control socket data. */
+void DestroyControl() {
+}
+
+/** Add the control socket descriptors to a select set. */
+int AddControlDescriptors(fd_set *fds, int maxfd) {
+   return maxfd;
+}
+
+/** Handle activity on the control socket descriptors. */
+void ProcessControl(const fd_set *fds) {
+}
+
+/** Send an event line to control clients that subscribed. */
+void NotifyControl(const char *format, ...) {
+}
+
+#endif /* USE_CONTROL */
+
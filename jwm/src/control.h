@@ -0,0 +1,38 @@
+/**
+ * @file control.h
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Header for the control socket.
+ *
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+/*@{*/
+void InitializeControl();
+void StartupControl();
+void ShutdownControl();
+void DestroyControl();
+/*@}*/
+
+/** Add the control socket descriptors to a select set.
+ * @param fds The set to update.
+ * @param maxfd The largest descriptor already in the set.
+ * @return The largest descriptor in the set.
+ */
+int AddControlDescriptors(fd_set *fds, int maxfd);
+
+/** Handle activity on the control socket descriptors.
+ * @param fds The set returned by select.
+ */
+void ProcessControl(const fd_set *fds);
+
+/** Send an event line to control clients that subscribed.
+ * @param format The printf-style format of the event.
+ */
+void NotifyControl(const char *format, ...);
+
+#endif /* CONTROL_H */
+
@@ -12,19 +12,39 @@
 #include "main.h"
 #include "error.h"
 
+/** Cursors other than the default are created on first use. */
+typedef enum {
+   CURSOR_MOVE,
+   CURSOR_NORTH,
+   CURSOR_SOUTH,
+   CURSOR_EAST,
+   CURSOR_WEST,
+   CURSOR_NORTH_EAST,
+   CURSOR_NORTH_WEST,
+   CURSOR_SOUTH_EAST,
+   CURSOR_SOUTH_WEST,
+   CURSOR_CHOOSE,
+   CURSOR_COUNT
+} CursorType;
+
+static const unsigned int cursorShapes[CURSOR_COUNT] = {
+   XC_fleur,
+   XC_top_side,
+   XC_bottom_side,
+   XC_right_side,
+   XC_left_side,
+   XC_ur_angle,
+   XC_ul_angle,
+   XC_lr_angle,
+   XC_ll_angle,
+   XC_tcross
+};
+
 static Cursor defaultCursor;
-static Cursor moveCursor;
-static Cursor northCursor;
-static Cursor southCursor;
-static Cursor eastCursor;
-static Cursor westCursor;
-static Cursor northEastCursor;
-static Cursor northWestCursor;
-static Cursor southEastCursor;
-static Cursor southWestCursor;
-static Cursor chooseCursor;
+static Cursor cursors[CURSOR_COUNT];
 
 static Cursor GetResizeCursor(BorderActionType action);
+static Cursor GetCursor(CursorType type);
 static Cursor CreateCursor(unsigned int shape);
 
 static int mousex;
@@ -40,18 +60,12 @@ void StartupCursors() {
    Window win1, win2;
    int winx, winy;
    unsigned int mask;
+   int x;
 
    defaultCursor = CreateCursor(XC_left_ptr);
-   moveCursor = CreateCursor(XC_fleur);
-   northCursor = CreateCursor(XC_top_side);
-   southCursor = CreateCursor(XC_bottom_side);
-   eastCursor = CreateCursor(XC_right_side);
-   westCursor = CreateCursor(XC_left_side);
-   northEastCursor = CreateCursor(XC_ur_angle);
-   northWestCursor = CreateCursor(XC_ul_angle);
-   southEastCursor = CreateCursor(XC_lr_angle);
-   southWestCursor = CreateCursor(XC_ll_angle);
-   chooseCursor = CreateCursor(XC_tcross);
+   for(x = 0; x < CURSOR_COUNT; x++) {
+      cursors[x] = None;
+   }
 
    JXQueryPointer(display, rootWindow, &win1, &win2,
                   &mousex, &mousey, &winx, &winy, &mask);
@@ -63,20 +77,26 @@ Cursor CreateCursor(unsigned int shape) {
    return JXCreateFontCursor(display, shape);
 }
 
+/** Get a cursor, creating it if needed. */
+Cursor GetCursor(CursorType type) {
+   if(cursors[type] == None) {
+      cursors[type] = CreateCursor(cursorShapes[type]);
+   }
+   return cursors[type];
+}
+
 /** Shutdown cursor support. */
 void ShutdownCursors() {
 
+   int x;
+
    JXFreeCursor(display, defaultCursor);
-   JXFreeCursor(display, moveCursor);
-   JXFreeCursor(display, northCursor);
-   JXFreeCursor(display, southCursor);
-   JXFreeCursor(display, eastCursor);
-   JXFreeCursor(display, westCursor);
-   JXFreeCursor(display, northEastCursor);
-   JXFreeCursor(display, northWestCursor);
-   JXFreeCursor(display, southEastCursor);
-   JXFreeCursor(display, southWestCursor);
-   JXFreeCursor(display, chooseCursor);
+   for(x = 0; x < CURSOR_COUNT; x++) {
+      if(cursors[x] != None) {
+         JXFreeCursor(display, cursors[x]);
+         cursors[x] = None;
+      }
+   }
 
 }
 
@@ -110,25 +130,25 @@ Cursor GetResizeCursor(BorderActionType action) {
 
    if(action & BA_RESIZE_N) {
       if(action & BA_RESIZE_E) {
-         return northEastCursor;
+         return GetCursor(CURSOR_NORTH_EAST);
       } else if(action & BA_RESIZE_W) {
-         return northWestCursor;
+         return GetCursor(CURSOR_NORTH_WEST);
       } else {
-         return northCursor;
+         return GetCursor(CURSOR_NORTH);
       }
    } else if(action & BA_RESIZE_S) {
       if(action & BA_RESIZE_E) {
-         return southEastCursor;
+         return GetCursor(CURSOR_SOUTH_EAST);
       } else if(action & BA_RESIZE_W) {
-         return southWestCursor;
+         return GetCursor(CURSOR_SOUTH_WEST);
       } else {
-         return southCursor;
+         return GetCursor(CURSOR_SOUTH);
       }
    } else {
       if(action & BA_RESIZE_E) {
-         return eastCursor;
+         return GetCursor(CURSOR_EAST);
       } else {
-         return westCursor;
+         return GetCursor(CURSOR_WEST);
       }
    }
 
@@ -161,7 +181,8 @@ int GrabMouseForMove() {
 
    result = JXGrabPointer(display, rootWindow, False,
       ButtonPressMask | ButtonReleaseMask | PointerMotionMask,
-      GrabModeAsync, GrabModeAsync, None, moveCursor, CurrentTime);
+      GrabModeAsync, GrabModeAsync, None, GetCursor(CURSOR_MOVE),
+      CurrentTime);
 
    if(JLIKELY(result == GrabSuccess)) {
       return 1;
@@ -195,7 +216,8 @@ int GrabMouseForChoose() {
 
    result = JXGrabPointer(display, rootWindow, False,
       ButtonPressMask | ButtonReleaseMask | PointerMotionMask,
-      GrabModeAsync, GrabModeAsync, None, chooseCursor, CurrentTime);
+      GrabModeAsync, GrabModeAsync, None, GetCursor(CURSOR_CHOOSE),
+      CurrentTime);
 
    if(JLIKELY(result == GrabSuccess)) {
       return 1;
@@ -29,24 +29,52 @@ void Debug(const char *str, ...) {
 
 #ifdef DEBUG
 
+#include <signal.h>
+
 #define CHECKPOINT_LIST_SIZE 8
+#define MEMORY_HASH_SIZE 1024
+#define SITE_HASH_SIZE 256
 
-typedef struct MemoryType {
+/** Allocation statistics for a call site. */
+typedef struct SiteType {
    const char *file;
    unsigned int line;
+   size_t liveBytes;          /**< Bytes currently allocated. */
+   size_t peakBytes;          /**< Maximum of liveBytes. */
+   size_t totalBytes;         /**< Total bytes ever allocated. */
+   unsigned int liveCount;    /**< Allocations currently live. */
+   unsigned int allocCount;   /**< Total number of allocations. */
+   unsigned int releaseCount; /**< Total number of releases. */
+   struct SiteType *next;
+} SiteType;
+
+typedef struct MemoryType {
+   SiteType *site;
    size_t size;
    void *pointer;
    struct MemoryType *next;
 } MemoryType;
 
-static MemoryType *allocations = NULL;
+static MemoryType *allocations[MEMORY_HASH_SIZE];
+static SiteType *sites[SITE_HASH_SIZE];
+static volatile sig_atomic_t shouldShowMemory = 0;
 
 static const char *checkpointFile[CHECKPOINT_LIST_SIZE];
 static unsigned int checkpointLine[CHECKPOINT_LIST_SIZE];
 static int checkpointOffset;
 
+static unsigned int GetPointerHash(const void *ptr);
+static SiteType *GetSite(const char *file, unsigned int line);
+static void InsertAllocation(MemoryType *mp, const char *file,
+                             unsigned int line);
+static MemoryType *RemoveAllocation(const void *ptr);
+static void ShowMemory();
+static int CompareSites(const void *a, const void *b);
+static void HandleShowMemory(int sig);
+
 /** Start the debugger. */
 void DEBUG_StartDebug(const char *file, unsigned int line) {
+   struct sigaction sa;
    int x;
 
    Debug("%s[%u]: debug mode started", file, line);
@@ -57,29 +85,39 @@ void DEBUG_StartDebug(const char *file, unsigned int line) {
       checkpointLine[x] = 0;
    }
 
+   /* Dump allocation statistics on SIGUSR1. */
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = HandleShowMemory;
+   sigaction(SIGUSR1, &sa, NULL);
+
 }
 
 /** Stop the debugger. */
 void DEBUG_StopDebug(const char *file, unsigned int line) {
    MemoryType *mp;
    unsigned int count = 0;
+   int x;
 
    Debug("%s[%u]: debug mode stopped", file, line);
 
-   if(allocations) {
-      Debug("MEMORY: memory leaks follow");
-      for(mp = allocations; mp; mp = mp->next) {
+   ShowMemory();
+
+   for(x = 0; x < MEMORY_HASH_SIZE; x++) {
+      for(mp = allocations[x]; mp; mp = mp->next) {
+         if(count == 0) {
+            Debug("MEMORY: memory leaks follow");
+         }
          Debug("        %u bytes in %s at line %u",
-            mp->size, mp->file, mp->line);
+            (unsigned int)mp->size, mp->site->file, mp->site->line);
          ++count;
       }
-      if(count == 1) {
-         Debug("MEMORY: 1 memory leak");
-      } else {
-         Debug("MEMORY: %u memory leaks", count);
-      }
-   } else {
+   }
+   if(count == 0) {
       Debug("MEMORY: no memory leaks");
+   } else if(count == 1) {
+      Debug("MEMORY: 1 memory leak");
+   } else {
+      Debug("MEMORY: %u memory leaks", count);
    }
 
 }
@@ -92,6 +130,11 @@ void DEBUG_SetCheckpoint(const char *file, unsigned int line) {
 
    checkpointOffset = (checkpointOffset + 1) % CHECKPOINT_LIST_SIZE;
 
+   if(shouldShowMemory) {
+      shouldShowMemory = 0;
+      ShowMemory();
+   }
+
 }
 
 /** Display the location of the last checkpoint. */
@@ -122,10 +165,7 @@ void *DEBUG_Allocate(size_t size, const char *file, unsigned int line) {
    mp = (MemoryType*)malloc(sizeof(MemoryType));
    Assert(mp);
 
-   mp->file = file;
-   mp->line = line;
    mp->size = size;
-
    mp->pointer = malloc(size + sizeof(char));
    if(!mp->pointer) {
       Debug("MEMORY: %s[%u]: Memory allocation failed (%d bytes)",
@@ -139,8 +179,7 @@ void *DEBUG_Allocate(size_t size, const char *file, unsigned int line) {
    /* Canary value for buffer overflow checking. */
    ((char*)mp->pointer)[size] = 42;
 
-   mp->next = allocations;
-   allocations = mp;
+   InsertAllocation(mp, file, line);
 
    return mp->pointer;
 }
@@ -159,35 +198,29 @@ void *DEBUG_Reallocate(void *ptr, size_t size, const char *file,
       Debug("MEMORY: %s[%u]: Attempt to reallocate NULL pointer. "
          "Calling Allocate...", file, line);
       return DEBUG_Allocate(size, file, line);
-   } else {
+   }
 
-      for(mp = allocations; mp; mp = mp->next) {
-         if(mp->pointer == ptr) {
-
-            if(((char*)ptr)[mp->size] != 42) {
-               Debug("MEMORY: %s[%u]: The canary is dead.", file, line);
-            }
-
-            mp->file = file;
-            mp->line = line;
-            mp->size = size;
-            mp->pointer = realloc(ptr, size + sizeof(char));
-            if(!mp->pointer) {
-               Debug("MEMORY: %s[%u]: Failed to reallocate %d bytes.",
-                  file, line, size);
-               Assert(0);
-            }
-            ((char*)mp->pointer)[size] = 42;
-            return mp->pointer;
-         }
+   mp = RemoveAllocation(ptr);
+   if(mp) {
+
+      if(((char*)ptr)[mp->size] != 42) {
+         Debug("MEMORY: %s[%u]: The canary is dead.", file, line);
+      }
+
+      mp->size = size;
+      mp->pointer = realloc(ptr, size + sizeof(char));
+      if(!mp->pointer) {
+         Debug("MEMORY: %s[%u]: Failed to reallocate %d bytes.",
+            file, line, size);
+         Assert(0);
       }
 
+   } else {
+
       Debug("MEMORY: %s[%u]: Attempt to reallocate unallocated pointer",
          file, line);
       mp = malloc(sizeof(MemoryType));
       Assert(mp);
-      mp->file = file;
-      mp->line = line;
       mp->size = size;
       mp->pointer = malloc(size + sizeof(char));
       if(!mp->pointer) {
@@ -196,19 +229,19 @@ void *DEBUG_Reallocate(void *ptr, size_t size, const char *file,
          Assert(0);
       }
       memset(mp->pointer, 85, size);
-      ((char*)mp->pointer)[size] = 42;
-
-      mp->next = allocations;
-      allocations = mp;
 
-      return mp->pointer;
    }
 
+   ((char*)mp->pointer)[size] = 42;
+   InsertAllocation(mp, file, line);
+
+   return mp->pointer;
+
 }
 
 /** Release memory and log. */
 void DEBUG_Release(void **ptr, const char *file, unsigned int line) {
-   MemoryType *mp, *last;
+   MemoryType *mp;
 
    if(!ptr) {
       Debug("MEMORY: %s[%u]: Invalid attempt to release", file, line);
@@ -216,30 +249,24 @@ void DEBUG_Release(void **ptr, const char *file, unsigned int line) {
       Debug("MEMORY: %s[%u]: Attempt to delete NULL pointer",
          file, line);
    } else {
-      last = NULL;
-      for(mp = allocations; mp; mp = mp->next) {
-         if(mp->pointer == *ptr) {
-            if(last) {
-               last->next = mp->next;
-            } else {
-               allocations = mp->next;
-            }
-
-            if(((char*)*ptr)[mp->size] != 42) {
-               Debug("MEMORY: %s[%u]: The canary is dead.", file, line);
-            }
-
-            memset(*ptr, 0xFF, mp->size);
-            free(mp);
-            free(*ptr);
-            *ptr = NULL;
-            return;
+
+      mp = RemoveAllocation(*ptr);
+      if(mp) {
+
+         if(((char*)*ptr)[mp->size] != 42) {
+            Debug("MEMORY: %s[%u]: The canary is dead.", file, line);
          }
-         last = mp;
+
+         memset(*ptr, 0xFF, mp->size);
+         free(mp);
+         free(*ptr);
+         *ptr = NULL;
+         return;
+
       }
+
       Debug("MEMORY: %s[%u]: Attempt to delete unallocated pointer",
          file, line);
-      memset(*ptr, 0xFF, mp->size);
       free(*ptr);
 
       /* This address should cause a segfault or bus error. */
@@ -248,7 +275,170 @@ void DEBUG_Release(void **ptr, const char *file, unsigned int line) {
    }
 }
 
+/** Get the hash bucket for an allocated pointer. */
+unsigned int GetPointerHash(const void *ptr) {
+   unsigned long value = (unsigned long)ptr;
+   return (unsigned int)((value >> 4) ^ (value >> 14)) % MEMORY_HASH_SIZE;
+}
+
+/** Get (or create) the statistics for a call site. */
+SiteType *GetSite(const char *file, unsigned int line) {
+
+   SiteType *sp;
+   unsigned int hash;
+   int x;
+
+   hash = line;
+   for(x = 0; file[x]; x++) {
+      hash = hash * 31 + (unsigned char)file[x];
+   }
+   hash %= SITE_HASH_SIZE;
+
+   for(sp = sites[hash]; sp; sp = sp->next) {
+      if(sp->line == line && !strcmp(sp->file, file)) {
+         return sp;
+      }
+   }
+
+   sp = (SiteType*)malloc(sizeof(SiteType));
+   Assert(sp);
+   memset(sp, 0, sizeof(SiteType));
+   sp->file = file;
+   sp->line = line;
+   sp->next = sites[hash];
+   sites[hash] = sp;
+
+   return sp;
+
+}
+
+/** Record an allocation made at a call site. */
+void InsertAllocation(MemoryType *mp, const char *file, unsigned int line) {
+
+   SiteType *sp;
+   unsigned int hash;
+
+   sp = GetSite(file, line);
+   sp->liveBytes += mp->size;
+   sp->totalBytes += mp->size;
+   sp->liveCount += 1;
+   sp->allocCount += 1;
+   if(sp->liveBytes > sp->peakBytes) {
+      sp->peakBytes = sp->liveBytes;
+   }
+   mp->site = sp;
+
+   hash = GetPointerHash(mp->pointer);
+   mp->next = allocations[hash];
+   allocations[hash] = mp;
+
+}
+
+/** Remove an allocation from the table and update its call site. */
+MemoryType *RemoveAllocation(const void *ptr) {
+
+   MemoryType **mpp;
+   MemoryType *mp;
+
+   for(mpp = &allocations[GetPointerHash(ptr)]; *mpp; mpp = &(*mpp)->next) {
+      mp = *mpp;
+      if(mp->pointer == ptr) {
+         *mpp = mp->next;
+         mp->site->liveBytes -= mp->size;
+         mp->site->liveCount -= 1;
+         mp->site->releaseCount += 1;
+         return mp;
+      }
+   }
+
+   return NULL;
+
+}
+
+/** Compare call sites by live bytes and then by total bytes. */
+int CompareSites(const void *a, const void *b) {
+
+   const SiteType *sa = *(const SiteType**)a;
+   const SiteType *sb = *(const SiteType**)b;
+
+   if(sa->liveBytes != sb->liveBytes) {
+      return sa->liveBytes < sb->liveBytes ? 1 : -1;
+   }
+   if(sa->totalBytes != sb->totalBytes) {
+      return sa->totalBytes < sb->totalBytes ? 1 : -1;
+   }
+   return 0;
+
+}
+
+/** Display allocation statistics for each call site. */
+void ShowMemory() {
+
+   SiteType **list;
+   SiteType *sp;
+   size_t liveBytes;
+   unsigned int count;
+   int x, y;
+
+   count = 0;
+   for(x = 0; x < SITE_HASH_SIZE; x++) {
+      for(sp = sites[x]; sp; sp = sp->next) {
+         ++count;
+      }
+   }
+   if(count == 0) {
+      return;
+   }
+
+   list = (SiteType**)malloc(sizeof(SiteType*) * count);
+   Assert(list);
+   y = 0;
+   for(x = 0; x < SITE_HASH_SIZE; x++) {
+      for(sp = sites[x]; sp; sp = sp->next) {
+         list[y++] = sp;
+      }
+   }
+   qsort(list, count, sizeof(SiteType*), CompareSites);
+
+   Debug("MEMORY: %10s %10s %10s %8s %8s  site",
+         "live", "peak", "churn", "allocs", "frees");
+   liveBytes = 0;
+   for(x = 0; x < count; x++) {
+      sp = list[x];
+      Debug("MEMORY: %10lu %10lu %10lu %8u %8u  %s[%u]",
+            (unsigned long)sp->liveBytes, (unsigned long)sp->peakBytes,
+            (unsigned long)sp->totalBytes, sp->allocCount,
+            sp->releaseCount, sp->file, sp->line);
+      liveBytes += sp->liveBytes;
+   }
+   Debug("MEMORY: %lu bytes live in %u call sites",
+         (unsigned long)liveBytes, count);
+
+   free(list);
+
+}
+
+/** Call a function with the live memory of each allocation site. */
+void DEBUG_ForEachSite(void (*func)(const char*, size_t, unsigned int)) {
+
+   SiteType *sp;
+   int x;
+
+   for(x = 0; x < SITE_HASH_SIZE; x++) {
+      for(sp = sites[x]; sp; sp = sp->next) {
+         if(sp->liveCount > 0) {
+            (func)(sp->file, sp->liveBytes, sp->liveCount);
+         }
+      }
+   }
+
+}
+
+/** Signal handler to request allocation statistics. */
+void HandleShowMemory(int sig) {
+   shouldShowMemory = 1;
+}
+
 #undef CHECKPOINT_LIST_SIZE
 
 #endif
-
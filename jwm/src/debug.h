@@ -86,6 +86,8 @@ void Debug(const char *str, ...);
    void *DEBUG_Reallocate(void*, size_t, const char*, unsigned int);
    void DEBUG_Release(void**, const char*, unsigned int);
 
+   void DEBUG_ForEachSite(void (*)(const char*, size_t, unsigned int));
+
 #else /* DEBUG */
 
 #   define Assert( x )           ((void)0)
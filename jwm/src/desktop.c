@@ -19,6 +19,7 @@
 #include "menu.h"
 #include "misc.h"
 #include "background.h"
+#include "control.h"
 
 char **desktopNames = NULL;
 
@@ -120,11 +121,18 @@ int BelowDesktop() {
    }
 }
 
-/** Change to the specified desktop. */
+/** Change to the specified desktop.
+ * The windows of the old desktop are lowered, the windows of the new
+ * desktop are stacked and mapped from the top down, and only then are
+ * the old windows unmapped. This way nothing behind the old desktop is
+ * exposed while switching.
+ */
 void ChangeDesktop(unsigned int desktop) {
 
    ClientNode *np;
-   unsigned int x;
+   ClientNode *focus;
+   unsigned int oldDesktop;
+   int x;
 
    if(JUNLIKELY(desktop >= desktopCount)) {
       return;
@@ -134,38 +142,67 @@ void ChangeDesktop(unsigned int desktop) {
       return;
    }
 
-   /* Hide clients from the old desktop.
-    * Note that we show clients in a separate loop to prevent an issue
-    * with clients losing focus.
-    */
+   oldDesktop = currentDesktop;
+   currentDesktop = desktop;
+
+   StartStateBatch();
+
+   /* Update the state of clients and lower the old desktop. */
+   focus = NULL;
    for(x = 0; x < LAYER_COUNT; x++) {
       for(np = nodes[x]; np; np = np->next) {
          if(np->state.status & STAT_STICKY) {
             continue;
          }
-         if(np->state.desktop == currentDesktop) {
-            HideClient(np);
+         if(np->state.desktop == desktop) {
+            if(np->state.status & STAT_HIDDEN) {
+               np->state.status &= ~STAT_HIDDEN;
+               if((np->state.status & (STAT_MAPPED | STAT_SHADED))
+                  && (np->state.status & STAT_ACTIVE)) {
+                  focus = np;
+               }
+            }
+         } else if(np->state.desktop == oldDesktop) {
+            np->state.status |= STAT_HIDDEN;
+            if(np->state.status & (STAT_MAPPED | STAT_SHADED)) {
+               JXLowerWindow(display, np->parent);
+            }
          }
       }
    }
 
-   /* Show clients on the new desktop. */
-   for(x = 0; x < LAYER_COUNT; x++) {
+   RestackClients();
+
+   /* Map the new desktop from the top of the stack down. */
+   for(x = LAYER_COUNT - 1; x >= 0; x--) {
       for(np = nodes[x]; np; np = np->next) {
-         if(np->state.status & STAT_STICKY) {
-            continue;
+         if(   np->state.desktop == desktop
+            && !(np->state.status & (STAT_STICKY | STAT_HIDDEN))
+            && (np->state.status & (STAT_MAPPED | STAT_SHADED))) {
+            JXMapWindow(display, np->parent);
          }
-         if(np->state.desktop == desktop) {
-            ShowClient(np);
+      }
+   }
+
+   /* Remove the old desktop, which is now covered. */
+   for(x = 0; x < LAYER_COUNT; x++) {
+      for(np = nodes[x]; np; np = np->next) {
+         if(   np->state.desktop == oldDesktop
+            && np->state.desktop != desktop
+            && !(np->state.status & STAT_STICKY)) {
+            HideClient(np);
          }
       }
    }
 
-   currentDesktop = desktop;
+   if(focus) {
+      FocusClient(focus);
+   }
 
    SetCardinalAtom(rootWindow, ATOM_NET_CURRENT_DESKTOP, currentDesktop);
+   NotifyControl("desktop %u", currentDesktop);
 
-   RestackClients();
+   FinishStateBatch();
 
    UpdatePager();
    UpdateTaskBar();
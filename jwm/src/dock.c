@@ -61,11 +61,16 @@ static int UndockWindow(Window win);
 
 static void UpdateDock();
 static void GetDockSize(int *width, int *height);
+static void ReleaseDock();
 
-/** Initialize dock data. */
+/** Initialize dock data.
+ * A dock kept by a reload keeps its items and the selection.
+ */
 void InitializeDock() {
-   dockItemCount = 0;
-   owner = 0;
+   if(!dock) {
+      dockItemCount = 0;
+      owner = 0;
+   }
 }
 
 /** Startup the dock. */
@@ -78,6 +83,14 @@ void StartupDock() {
       return;
    }
 
+   if(!dock->cp) {
+      /* A reload removed the dock. */
+      ReleaseDock();
+      Release(dock);
+      dock = NULL;
+      return;
+   }
+
    if(dock->window == None) {
 
       /* No dock yet. */
@@ -98,42 +111,65 @@ void StartupDock() {
          | SubstructureRedirectMask
          | PointerMotionMask | PointerMotionHintMask);
 
+   } else {
+
+      /* Kept by a reload; the tray style may have changed. */
+      JXSetWindowBackground(display, dock->window, colors[COLOR_TRAY_BG]);
+
    }
    dock->cp->window = dock->window;
 
 }
 
-/** Shutdown the dock. */
+/** Shutdown the dock.
+ * On a reload the dock window is moved to the root window so the docked
+ * programs and the selection survive the trays.
+ */
 void ShutdownDock() {
 
-   DockNode *np;
+   if(dock && shouldReload) {
+      JXUnmapWindow(display, dock->window);
+      JXReparentWindow(display, dock->window, rootWindow, 0, 0);
+      dock->cp->window = None;
+   } else if(dock) {
+      ReleaseDock();
+   }
 
-   if(dock) {
+}
 
-      /* Release memory used by the dock list. */
-      while(dock->nodes) {
-         np = dock->nodes->next;
-         JXReparentWindow(display, dock->nodes->window, rootWindow, 0, 0);
-         Release(dock->nodes);
-         dock->nodes = np;
-      }
+/** Release the dock items, the selection, and the dock window. */
+void ReleaseDock() {
 
-      /* Release the selection. */
-      if(owner) {
-         JXSetSelectionOwner(display, dockAtom, None, CurrentTime);
-      }
+   DockNode *np;
 
-      /* Destroy the dock window. */
-      JXDestroyWindow(display, dock->window);
+   /* Release memory used by the dock list. */
+   while(dock->nodes) {
+      np = dock->nodes->next;
+      JXReparentWindow(display, dock->nodes->window, rootWindow, 0, 0);
+      Release(dock->nodes);
+      dock->nodes = np;
+   }
+   dockItemCount = 0;
 
+   /* Release the selection. */
+   if(owner) {
+      JXSetSelectionOwner(display, dockAtom, None, CurrentTime);
+      owner = 0;
    }
 
+   /* Destroy the dock window. */
+   JXDestroyWindow(display, dock->window);
+
 }
 
-/** Destroy dock data. */
+/** Destroy dock data.
+ * On a reload the dock is kept for the next Dock tag.
+ */
 void DestroyDock() {
 
-   if(dock) {
+   if(dock && shouldReload) {
+      dock->cp = NULL;
+   } else if(dock) {
       Release(dock);
       dock = NULL;
    }
@@ -426,7 +462,7 @@ void DockWindow(Window win) {
    GetDockSize(&dock->cp->requestedWidth, &dock->cp->requestedHeight);
 
    /* It's safe to reparent at (0, 0) since we call
-    * ResizeTray which will invoke the Resize callback.
+    * ResizeTrayComponent which will invoke the Resize callback.
     */
    JXAddToSaveSet(display, win);
    JXSelectInput(display, win,
@@ -437,7 +473,7 @@ void DockWindow(Window win) {
    JXMapRaised(display, win);
 
    /* Resize the tray containing the dock. */
-   ResizeTray(dock->cp->tray);
+   ResizeTrayComponent(dock->cp);
 
 }
 
@@ -469,7 +505,7 @@ int UndockWindow(Window win) {
          GetDockSize(&dock->cp->requestedWidth, &dock->cp->requestedHeight);
 
          /* Resize the tray. */
-         ResizeTray(dock->cp->tray);
+         ResizeTrayComponent(dock->cp);
 
          return 1;
 
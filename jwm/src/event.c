@@ -14,6 +14,7 @@
 #include "clientlist.h"
 #include "clock.h"
 #include "confirm.h"
+#include "control.h"
 #include "cursor.h"
 #include "desktop.h"
 #include "dock.h"
@@ -34,6 +35,8 @@
 #include "traybutton.h"
 #include "winmenu.h"
 #include "error.h"
+#include "stats.h"
+#include "trace.h"
 
 #define MIN_TIME_DELTA 50
 
@@ -69,12 +72,25 @@ static void HandleNetWMState(const XClientMessageEvent *event,
 static void HandleShapeEvent(const XShapeEvent *event);
 #endif
 
+static int DispatchWindowEvent(const XEvent *event);
+
+/** Handler registered for a window. */
+typedef struct EventHandlerNode {
+   EventHandlerType handler;
+   void *data;
+} EventHandlerNode;
+
+/** Context used to find the handler for a window. */
+static XContext handlerContext = 0;
+
 /** Wait for an event and process it. */
 void WaitForEvent(XEvent *event) {
 
    struct timeval timeout;
    fd_set fds;
+   ProfileTime start;
    int fd;
+   int maxfd;
    int handled;
 
    fd = JXConnectionNumber(display);
@@ -82,12 +98,16 @@ void WaitForEvent(XEvent *event) {
    do {
 
       while(JXPending(display) == 0) {
+         FlushTrace();
          FD_ZERO(&fds);
          FD_SET(fd, &fds);
+         maxfd = AddControlDescriptors(&fds, fd);
          timeout.tv_usec = 0;
          timeout.tv_sec = 1;
-         if(select(fd + 1, &fds, NULL, NULL, &timeout) <= 0) {
+         if(select(maxfd + 1, &fds, NULL, NULL, &timeout) <= 0) {
             Signal();
+         } else {
+            ProcessControl(&fds);
          }
       }
 
@@ -95,6 +115,7 @@ void WaitForEvent(XEvent *event) {
 
       JXNextEvent(display, event);
       UpdateTime(event);
+      start = StartProfile();
 
       switch(event->type) {
       case ConfigureRequest:
@@ -163,22 +184,87 @@ void WaitForEvent(XEvent *event) {
       }
 
       if(!handled) {
-         handled = ProcessTrayEvent(event);
+         handled = DispatchWindowEvent(event);
       }
-      if(!handled) {
-         handled = ProcessDialogEvent(event);
-      }
-      if(!handled) {
-         handled = ProcessSwallowEvent(event);
-      }
-      if(!handled) {
-         handled = ProcessPopupEvent(event);
+      if(handled) {
+         StopEventProfile(event->type, start);
       }
 
    } while(handled && !shouldExit);
 
 }
 
+/** Wait a limited time for an event to arrive. */
+int PollForEvent(unsigned int ms) {
+
+   struct timeval timeout;
+   fd_set fds;
+   int fd;
+
+   if(JXPending(display)) {
+      return 1;
+   }
+
+   fd = JXConnectionNumber(display);
+   FD_ZERO(&fds);
+   FD_SET(fd, &fds);
+   timeout.tv_sec = ms / 1000;
+   timeout.tv_usec = (ms % 1000) * 1000;
+   if(select(fd + 1, &fds, NULL, NULL, &timeout) <= 0) {
+      return 0;
+   }
+
+   return JXPending(display) ? 1 : 0;
+
+}
+
+/** Pass an event to the handler registered for its window. */
+int DispatchWindowEvent(const XEvent *event) {
+
+   EventHandlerNode *hp;
+
+   if(handlerContext && !XFindContext(display, event->xany.window,
+                                      handlerContext, (void*)&hp)) {
+      return (hp->handler)(event, hp->data);
+   }
+
+   return 0;
+
+}
+
+/** Route events for a window to a handler. */
+void RegisterEventHandler(Window w, EventHandlerType handler, void *data) {
+
+   EventHandlerNode *hp;
+
+   Assert(handler);
+
+   if(!handlerContext) {
+      handlerContext = XUniqueContext();
+   }
+
+   if(XFindContext(display, w, handlerContext, (void*)&hp)) {
+      hp = Allocate(sizeof(EventHandlerNode));
+      XSaveContext(display, w, handlerContext, (void*)hp);
+   }
+   hp->handler = handler;
+   hp->data = data;
+
+}
+
+/** Stop routing events for a window. */
+void UnregisterEventHandler(Window w) {
+
+   EventHandlerNode *hp;
+
+   if(handlerContext && !XFindContext(display, w, handlerContext,
+                                      (void*)&hp)) {
+      XDeleteContext(display, w, handlerContext);
+      Release(hp);
+   }
+
+}
+
 /** Wake up components that need to run at certain times. */
 void Signal() {
 
@@ -200,17 +286,25 @@ void Signal() {
    SignalTrayButton(&now, x, y);
    SignalClock(&now, x, y);
    SignalTray(&now, x, y);
+   SignalSwallow(&now);
    SignalPager(&now, x, y);
    SignalPopup(&now, x, y);
+   SignalResources();
 
 }
 
 /** Process an event. */
 void ProcessEvent(XEvent *event) {
 
+   ProfileTime start;
+
+   start = StartProfile();
    switch(event->type) {
    case ButtonPress:
+      HandleButtonEvent(&event->xbutton);
+      break;
    case ButtonRelease:
+      ResetDialogButtons();
       HandleButtonEvent(&event->xbutton);
       break;
    case KeyPress:
@@ -238,6 +332,7 @@ void ProcessEvent(XEvent *event) {
       Debug("Unknown event type: %d", event->type);
       break;
    }
+   StopEventProfile(event->type, start);
 }
 
 /** Discard motion events for the specified window. */
@@ -780,6 +875,10 @@ void HandleClientMessage(const XClientMessageEvent *event) {
          Exit();
       } else if(event->message_type == atoms[ATOM_JWM_RELOAD]) {
          ReloadMenu();
+      } else if(event->message_type == atoms[ATOM_JWM_STATS]) {
+         WriteStats();
+      } else if(event->message_type == atoms[ATOM_JWM_REPORT]) {
+         WriteResourceReport();
       } else if(event->message_type == atoms[ATOM_NET_CURRENT_DESKTOP]) {
          ChangeDesktop(event->data.l[0]);
       } else {
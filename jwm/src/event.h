@@ -16,6 +16,12 @@ extern Time eventTime;
 /** Wait for an event and process it. */
 void WaitForEvent();
 
+/** Wait a limited time for an event to arrive.
+ * @param ms The maximum time to wait in milliseconds.
+ * @return 1 if an event is pending, 0 if the time expired.
+ */
+int PollForEvent(unsigned int ms);
+
 /** Process an event.
  * @param event The event to process.
  */
@@ -27,6 +33,27 @@ void ProcessEvent(XEvent *event);
  */
 void DiscardMotionEvents(XEvent *event, Window w);
 
+/** Handler for events on a registered window.
+ * @param event The event.
+ * @param data The data passed to RegisterEventHandler.
+ * @return 1 if handled, 0 if not handled.
+ */
+typedef int (*EventHandlerType)(const XEvent *event, void *data);
+
+/** Route events for a window to a handler.
+ * Events not handled by the main event loop are passed to the handler
+ * registered for the window they were sent to.
+ * @param w The window.
+ * @param handler The handler to call.
+ * @param data Data to pass to the handler.
+ */
+void RegisterEventHandler(Window w, EventHandlerType handler, void *data);
+
+/** Stop routing events for a window.
+ * @param w The window.
+ */
+void UnregisterEventHandler(Window w);
+
 /** Update the last event time.
  * @param event The event containing the time to use.
  */
@@ -16,15 +16,30 @@
 
 static const char *DEFAULT_FONT = "-*-courier-*-r-*-*-14-*-*-*-*-*-*-*";
 
-static char *fontNames[FONT_COUNT];
-
 #ifdef USE_XFT
-static XftFont *fonts[FONT_COUNT];
+typedef XftFont FontStruct;
 #else
-static XFontStruct *fonts[FONT_COUNT];
+typedef XFontStruct FontStruct;
+#endif
+
+/** An open font (shared by all components using the same name). */
+typedef struct FontNode {
+   char *name;
+   FontStruct *font;
+   struct FontNode *next;
+} FontNode;
+
+static char *fontNames[FONT_COUNT];
+static FontStruct *fonts[FONT_COUNT];
+static FontNode *openFonts;
+
+#ifndef USE_XFT
 static GC fontGC;
 #endif
 
+static FontStruct *GetFont(FontType type);
+static FontStruct *OpenFont(const char *name);
+
 /** Initialize font data. */
 void InitializeFonts() {
 
@@ -34,17 +49,19 @@ void InitializeFonts() {
       fonts[x] = NULL;
       fontNames[x] = NULL;
    }
+   openFonts = NULL;
 
 }
 
-/** Startup font support. */
+/** Startup font support.
+ * Fonts are opened when first used (see GetFont).
+ */
 void StartupFonts() {
 
 #ifndef USE_XFT
    XGCValues gcValues;
    unsigned long gcMask;
 #endif
-   int x;
 
    /* Inherit unset fonts from the tray for tray items. */
    if(!fontNames[FONT_TASK]) {
@@ -60,42 +77,7 @@ void StartupFonts() {
       fontNames[FONT_PAGER] = CopyString(fontNames[FONT_TRAY]);
    }
 
-#ifdef USE_XFT
-
-   for(x = 0; x < FONT_COUNT; x++) {
-      if(fontNames[x]) {
-         fonts[x] = JXftFontOpenName(display, rootScreen, fontNames[x]);
-         if(!fonts[x]) {
-            fonts[x] = JXftFontOpenXlfd(display, rootScreen, fontNames[x]);
-         }
-         if(JUNLIKELY(!fonts[x])) {
-            Warning(_("could not load font: %s"), fontNames[x]);
-         }
-      }
-      if(!fonts[x]) {
-         fonts[x] = JXftFontOpenXlfd(display, rootScreen, DEFAULT_FONT);
-      }
-      if(JUNLIKELY(!fonts[x])) {
-         FatalError(_("could not load the default font: %s"), DEFAULT_FONT);
-      }
-   }
-
-#else /* USE_XFT */
-
-   for(x = 0; x < FONT_COUNT; x++) {
-      if(fontNames[x]) {
-         fonts[x] = JXLoadQueryFont(display, fontNames[x]);
-         if(JUNLIKELY(!fonts[x] && fontNames[x])) {
-            Warning(_("could not load font: %s"), fontNames[x]);
-         }
-      }
-      if(!fonts[x]) {
-         fonts[x] = JXLoadQueryFont(display, DEFAULT_FONT);
-      }
-      if(JUNLIKELY(!fonts[x])) {
-         FatalError(_("could not load the default font: %s"), DEFAULT_FONT);
-      }
-   }
+#ifndef USE_XFT
 
    gcMask = GCGraphicsExposures;
    gcValues.graphics_exposures = False;
@@ -108,17 +90,23 @@ void StartupFonts() {
 /** Shutdown font support. */
 void ShutdownFonts() {
 
+   FontNode *fp;
    int x;
 
    for(x = 0; x < FONT_COUNT; x++) {
-      if(fonts[x]) {
+      fonts[x] = NULL;
+   }
+
+   while(openFonts) {
+      fp = openFonts->next;
 #ifdef USE_XFT
-         JXftFontClose(display, fonts[x]);
+      JXftFontClose(display, openFonts->font);
 #else
-         JXFreeFont(display, fonts[x]);
+      JXFreeFont(display, openFonts->font);
 #endif
-         fonts[x] = NULL;
-      }
+      Release(openFonts->name);
+      Release(openFonts);
+      openFonts = fp;
    }
 
 #ifndef USE_XFT
@@ -128,6 +116,66 @@ void ShutdownFonts() {
 #endif
 
 
+}
+
+/** Get the font for a component, opening it if needed. */
+FontStruct *GetFont(FontType type) {
+
+   if(JUNLIKELY(!fonts[type])) {
+      if(fontNames[type]) {
+         fonts[type] = OpenFont(fontNames[type]);
+      }
+      if(!fonts[type]) {
+         fonts[type] = OpenFont(DEFAULT_FONT);
+      }
+      if(JUNLIKELY(!fonts[type])) {
+         FatalError(_("could not load the default font: %s"), DEFAULT_FONT);
+      }
+   }
+
+   return fonts[type];
+
+}
+
+/** Open a font by name.
+ * Fonts are shared by name, so each name is only opened once.
+ * This returns NULL if the font could not be loaded.
+ */
+FontStruct *OpenFont(const char *name) {
+
+   FontNode *fp;
+   FontStruct *font;
+
+   for(fp = openFonts; fp; fp = fp->next) {
+      if(!strcmp(fp->name, name)) {
+         return fp->font;
+      }
+   }
+
+#ifdef USE_XFT
+   font = JXftFontOpenName(display, rootScreen, name);
+   if(!font) {
+      font = JXftFontOpenXlfd(display, rootScreen, name);
+   }
+#else
+   font = JXLoadQueryFont(display, name);
+#endif
+
+   if(JUNLIKELY(!font)) {
+      if(name != DEFAULT_FONT) {
+         Warning(_("could not load font: %s"), name);
+      }
+      return NULL;
+   }
+
+   fp = Allocate(sizeof(FontNode));
+   fp->name = CopyString(name);
+   fp->font = font;
+   fp->next = openFonts;
+   openFonts = fp;
+
+   return font;
+
 }
 
 /** Destroy font data. */
@@ -152,11 +200,10 @@ int GetStringWidth(FontType type, const char *str) {
    unsigned int length;
 
    Assert(str);
-   Assert(fonts[type]);
 
    length = strlen(str);
 
-   JXftTextExtentsUtf8(display, fonts[type], (const unsigned char*)str,
+   JXftTextExtentsUtf8(display, GetFont(type), (const unsigned char*)str,
                        length, &extents);
 
    return extents.xOff;
@@ -164,9 +211,8 @@ int GetStringWidth(FontType type, const char *str) {
 #else
 
    Assert(str);
-   Assert(fonts[type]);
 
-   return XTextWidth(fonts[type], str, strlen(str));
+   return XTextWidth(GetFont(type), str, strlen(str));
 
 #endif
 }
@@ -174,9 +220,11 @@ int GetStringWidth(FontType type, const char *str) {
 /** Get the height of a string. */
 int GetStringHeight(FontType type) {
 
-   Assert(fonts[type]);
+   FontStruct *font;
 
-   return fonts[type]->ascent + fonts[type]->descent;
+   font = GetFont(type);
+
+   return font->ascent + font->descent;
 
 }
 
@@ -204,6 +252,7 @@ void RenderString(Drawable d, FontType font, ColorType color,
    XftDraw *xd;
 #endif
 
+   FontStruct *fs;
    XRectangle rect;
    Region renderRegion;
    int len;
@@ -226,6 +275,8 @@ void RenderString(Drawable d, FontType font, ColorType color,
       return;
    }
 
+   fs = GetFont(font);
+
    /* Get the bounds for the string based on the specified width. */
    rect.x = x;
    rect.y = y;
@@ -267,8 +318,8 @@ void RenderString(Drawable d, FontType font, ColorType color,
 
    xd = XftDrawCreate(display, d, rootVisual, rootColormap);
    XftDrawSetClip(xd, renderRegion);
-   JXftDrawStringUtf8(xd, GetXftColor(color), fonts[font],
-                      x, y + fonts[font]->ascent,
+   JXftDrawStringUtf8(xd, GetXftColor(color), fs,
+                      x, y + fs->ascent,
                       (const unsigned char*)output, len);
    XftDrawDestroy(xd);
 
@@ -276,8 +327,8 @@ void RenderString(Drawable d, FontType font, ColorType color,
 
    JXSetForeground(display, fontGC, colors[color]);
    XSetRegion(display, fontGC, renderRegion);
-   JXSetFont(display, fontGC, fonts[font]->fid);
-   JXDrawString(display, d, fontGC, x, y + fonts[font]->ascent, output, len);
+   JXSetFont(display, fontGC, fs->fid);
+   JXDrawString(display, d, fontGC, x, y + fs->ascent, output, len);
 
 #endif
 
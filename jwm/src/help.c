@@ -45,6 +45,10 @@ void DisplayCompileOptions() {
    printf("shape ");
 #endif
 
+#ifdef USE_XCB
+   printf("xcb ");
+#endif
+
 #ifdef USE_XFT
    printf("xft ");
 #endif
@@ -72,8 +76,12 @@ void DisplayHelp() {
    printf("  -exit       Exit JWM (send _JWM_EXIT to the root)\n");
    printf("  -h          Display this help message\n");
    printf("  -p          Parse the configuration file and exit\n");
-   printf("  -reload     Reload menu (send _JWM_RELOAD to the root)\n");
+   printf("  -reload     Reload config (send _JWM_RELOAD to the root)\n");
+   printf("  -report     Show X resources and memory of the running JWM\n");
    printf("  -restart    Restart JWM (send _JWM_RESTART to the root)\n");
+   printf("  -stats      Show event and redraw timing of the running JWM\n");
+   printf("  -timing     Report the cost of each startup phase\n");
+   printf("  -trace F    Write a Chrome trace of event handling to F\n");
    printf("  -v          Display version information\n");
 }
 
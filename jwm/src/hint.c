@@ -129,6 +129,9 @@ static const AtomNode atomList[] = {
    { &atoms[ATOM_NET_CLIENT_LIST_STACKING],  "_NET_CLIENT_LIST_STACKING"   },
    { &atoms[ATOM_NET_WM_STRUT_PARTIAL],      "_NET_WM_STRUT_PARTIAL"       },
    { &atoms[ATOM_NET_WM_STRUT],              "_NET_WM_STRUT"               },
+   { &atoms[ATOM_NET_WM_SYNC_REQUEST],       "_NET_WM_SYNC_REQUEST"        },
+   { &atoms[ATOM_NET_WM_SYNC_REQUEST_COUNTER],
+      "_NET_WM_SYNC_REQUEST_COUNTER"},
    { &atoms[ATOM_NET_SYSTEM_TRAY_OPCODE],    "_NET_SYSTEM_TRAY_OPCODE"     },
    { &atoms[ATOM_NET_WM_WINDOW_OPACITY],     "_NET_WM_WINDOW_OPACITY"      },
 
@@ -136,14 +139,21 @@ static const AtomNode atomList[] = {
 
    { &atoms[ATOM_JWM_RESTART],               "_JWM_RESTART"                },
    { &atoms[ATOM_JWM_EXIT],                  "_JWM_EXIT"                   },
-   { &atoms[ATOM_JWM_RELOAD],                "_JWM_RELOAD"                 }
+   { &atoms[ATOM_JWM_RELOAD],                "_JWM_RELOAD"                 },
+   { &atoms[ATOM_JWM_STATS],                 "_JWM_STATS"                  },
+   { &atoms[ATOM_JWM_REPORT],                "_JWM_REPORT"                 }
 
 };
 
+/* Nesting depth of StartStateBatch and whether state was written. */
+static int stateBatchDepth = 0;
+static char stateBatchDirty = 0;
+
 static void WriteNetState(ClientNode *np);
 static void WriteNetAllowed(ClientNode *np);
 static void ReadWMHints(Window win, ClientState *state);
 static void ReadMotifHints(Window win, ClientState *state);
+static int ReceiveCardinal(PropertyRequest *rp, unsigned long *value);
 
 /** Initialize hints data. */
 void InitializeHints() {
@@ -154,8 +164,8 @@ void StartupHints() {
 
    unsigned long *array;
    char *data;
+   char **names;
    Atom *supported;
-   Window win;
    unsigned int x;
    unsigned int count;
 
@@ -177,10 +187,16 @@ void StartupHints() {
    array = (unsigned long*)data;
    supported = (Atom*)data;
 
-   /* Intern the atoms */
+   /* Intern the atoms (all at once to avoid a round trip for each). */
+   names = AllocateStack(sizeof(char*) * ATOM_COUNT);
    for(x = 0; x < ATOM_COUNT; x++) {
-      *atomList[x].atom = JXInternAtom(display, atomList[x].name, False);
+      names[x] = (char*)atomList[x].name;
    }
+   JXInternAtoms(display, names, ATOM_COUNT, False, supported);
+   for(x = 0; x < ATOM_COUNT; x++) {
+      *atomList[x].atom = supported[x];
+   }
+   ReleaseStack(names);
 
    /* _NET_SUPPORTED */
    for(x = FIRST_NET_ATOM; x <= LAST_NET_ATOM; x++) {
@@ -228,6 +244,20 @@ void StartupHints() {
       XA_CARDINAL, 32, PropModeReplace,
       (unsigned char*)array, 2);
 
+   WriteSupportingWindow();
+
+   ReleaseStack(data);
+
+}
+
+/** Set _NET_SUPPORTING_WM_CHECK.
+ * The supporting window is the first tray, so this is called again
+ * when the trays are created again.
+ */
+void WriteSupportingWindow() {
+
+   Window win;
+
    win = GetSupportingWindow();
    JXChangeProperty(display, win, atoms[ATOM_NET_WM_NAME],
       atoms[ATOM_UTF8_STRING], 8, PropModeReplace,
@@ -236,8 +266,6 @@ void StartupHints() {
    SetWindowAtom(rootWindow, ATOM_NET_SUPPORTING_WM_CHECK, win);
    SetWindowAtom(win, ATOM_NET_SUPPORTING_WM_CHECK, win);
 
-   ReleaseStack(data);
-
 }
 
 /** Shutdown hints. */
@@ -330,10 +358,29 @@ void WriteState(ClientNode *np) {
    }
 
    /* Flush to the server. */
-   JXSync(display, False);
+   if(stateBatchDepth == 0) {
+      JXSync(display, False);
+   } else {
+      stateBatchDirty = 1;
+   }
 
 }
 
+/** Start writing the state of several clients. */
+void StartStateBatch() {
+   ++stateBatchDepth;
+}
+
+/** Finish writing the state of several clients. */
+void FinishStateBatch() {
+   Assert(stateBatchDepth > 0);
+   --stateBatchDepth;
+   if(stateBatchDepth == 0 && stateBatchDirty) {
+      stateBatchDirty = 0;
+      JXSync(display, False);
+   }
+}
+
 /** Write the net state hint for a client. */
 void WriteNetState(ClientNode *np) {
 
@@ -457,6 +504,10 @@ ClientState ReadWindowState(Window win) {
    unsigned long card;
    int maxVert, maxHorz;
    int fullScreen;
+   PropertyRequest desktopRequest;
+   PropertyRequest stateRequest;
+   PropertyRequest typeRequest;
+   PropertyRequest opacityRequest;
 
    Assert(win != None);
 
@@ -466,11 +517,22 @@ ClientState ReadWindowState(Window win) {
    result.desktop = currentDesktop;
    result.opacity = 0xFFFFFFFF;
 
+   /* Ask for the EWMH properties first so that the replies can arrive
+    * while the other hints are read. */
+   JXRequestProperty(display, &desktopRequest, win,
+                     atoms[ATOM_NET_WM_DESKTOP], 0, 1, XA_CARDINAL);
+   JXRequestProperty(display, &stateRequest, win,
+                     atoms[ATOM_NET_WM_STATE], 0, 32, XA_ATOM);
+   JXRequestProperty(display, &typeRequest, win,
+                     atoms[ATOM_NET_WM_WINDOW_TYPE], 0, 32, XA_ATOM);
+   JXRequestProperty(display, &opacityRequest, win,
+                     atoms[ATOM_NET_WM_WINDOW_OPACITY], 0, 1, XA_CARDINAL);
+
    ReadWMHints(win, &result);
    ReadMotifHints(win, &result);
 
    /* _NET_WM_DESKTOP */
-   if(GetCardinalAtom(win, ATOM_NET_WM_DESKTOP, &card)) {
+   if(ReceiveCardinal(&desktopRequest, &card)) {
       if(card == ~0UL) {
          result.status |= STAT_STICKY;
       } else if(card < desktopCount) {
@@ -481,9 +543,8 @@ ClientState ReadWindowState(Window win) {
    }
 
    /* _NET_WM_STATE */
-   status = JXGetWindowProperty(display, win,
-      atoms[ATOM_NET_WM_STATE], 0, 32, False, XA_ATOM, &realType,
-      &realFormat, &count, &extra, &temp);
+   status = JXReceiveProperty(display, &stateRequest, &realType,
+                              &realFormat, &count, &extra, &temp);
    if(status == Success) {
       if(count > 0) {
          maxVert = 0;
@@ -528,9 +589,8 @@ ClientState ReadWindowState(Window win) {
    }
 
    /* _NET_WM_WINDOW_TYPE */
-   status = JXGetWindowProperty(display, win, atoms[ATOM_NET_WM_WINDOW_TYPE],
-                                0, 32, False, XA_ATOM, &realType, &realFormat,
-                                &count, &extra, &temp);
+   status = JXReceiveProperty(display, &typeRequest, &realType,
+                              &realFormat, &count, &extra, &temp);
    if(status == Success) {
       /* Loop until we hit a window type we recognize. */
       state = (Atom*)temp;
@@ -568,7 +628,7 @@ ClientState ReadWindowState(Window win) {
    }
 
    /* _NET_WM_WINDOW_OPACITY */
-   if(GetCardinalAtom(win, ATOM_NET_WM_WINDOW_OPACITY, &card)) {
+   if(ReceiveCardinal(&opacityRequest, &card)) {
       result.opacity = card;
    }
 
@@ -679,6 +739,8 @@ ClientProtocolType ReadWMProtocols(Window w) {
          result |= PROT_DELETE;
       } else if(p[x] == atoms[ATOM_WM_TAKE_FOCUS]) {
          result |= PROT_TAKE_FOCUS;
+      } else if(p[x] == atoms[ATOM_NET_WM_SYNC_REQUEST]) {
+         result |= PROT_SYNC_REQUEST;
       }
    }
 
@@ -906,6 +968,20 @@ void ReadMotifHints(Window win, ClientState *state) {
 /** Read a cardinal atom. */
 int GetCardinalAtom(Window window, AtomType atom, unsigned long *value) {
 
+   PropertyRequest request;
+
+   Assert(window != None);
+   Assert(value);
+
+   JXRequestProperty(display, &request, window, atoms[atom], 0, 1,
+                     XA_CARDINAL);
+   return ReceiveCardinal(&request, value);
+
+}
+
+/** Receive a cardinal atom requested with JXRequestProperty. */
+int ReceiveCardinal(PropertyRequest *rp, unsigned long *value) {
+
    unsigned long count;
    int status;
    unsigned long extra;
@@ -914,11 +990,8 @@ int GetCardinalAtom(Window window, AtomType atom, unsigned long *value) {
    unsigned char *data;
    int ret;
 
-   Assert(window != None);
-   Assert(value);
-
-   status = JXGetWindowProperty(display, window, atoms[atom], 0, 1, False,
-      XA_CARDINAL, &realType, &realFormat, &count, &extra, &data);
+   status = JXReceiveProperty(display, rp, &realType, &realFormat,
+                              &count, &extra, &data);
 
    ret = 0;
    if(status == Success && data) {
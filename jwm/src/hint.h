@@ -85,6 +85,9 @@ typedef enum {
    ATOM_NET_WM_STRUT_PARTIAL,
    ATOM_NET_WM_STRUT,
 
+   ATOM_NET_WM_SYNC_REQUEST,
+   ATOM_NET_WM_SYNC_REQUEST_COUNTER,
+
    ATOM_NET_SYSTEM_TRAY_OPCODE,
 
    ATOM_NET_WM_WINDOW_OPACITY,
@@ -96,6 +99,8 @@ typedef enum {
    ATOM_JWM_RESTART,
    ATOM_JWM_EXIT,
    ATOM_JWM_RELOAD,
+   ATOM_JWM_STATS,
+   ATOM_JWM_REPORT,
 
    ATOM_COUNT
 } AtomType;
@@ -128,9 +133,10 @@ typedef struct ClientState {
 
 /** Client protocols (to be used as a bit mask). */
 typedef enum {
-   PROT_NONE       = 0,
-   PROT_DELETE     = 1,
-   PROT_TAKE_FOCUS = 2
+   PROT_NONE         = 0,
+   PROT_DELETE       = 1,
+   PROT_TAKE_FOCUS   = 2,
+   PROT_SYNC_REQUEST = 4
 } ClientProtocolType;
 
 extern Atom atoms[ATOM_COUNT];
@@ -140,6 +146,9 @@ void StartupHints();
 void ShutdownHints();
 void DestroyHints();
 
+/** Set _NET_SUPPORTING_WM_CHECK on the root and supporting windows. */
+void WriteSupportingWindow();
+
 /** Determine the current desktop. */
 void ReadCurrentDesktop();
 
@@ -190,6 +199,14 @@ ClientState ReadWindowState(Window win);
  */
 void WriteState(struct ClientNode *np);
 
+/** Start writing the state of several clients.
+ * WriteState does not wait for the server until FinishStateBatch.
+ */
+void StartStateBatch();
+
+/** Finish writing the state of several clients. */
+void FinishStateBatch();
+
 /** Read a cardinal atom.
  * @param window The window.
  * @param atom The atom to read.
@@ -16,6 +16,8 @@
 #include "misc.h"
 #include "hint.h"
 #include "color.h"
+#include "stats.h"
+#include "cache.h"
 
 IconNode emptyIcon;
 
@@ -26,6 +28,12 @@ IconNode emptyIcon;
 /* Must be a power of two. */
 #define HASH_SIZE 128
 
+/** Maximum number of images to consider in _NET_WM_ICON. */
+#define MAX_NET_ICONS 32
+
+/** Maximum size (in pixels) of an image from _NET_WM_ICON. */
+#define MAX_NET_ICON_PIXELS (256 * 256 * 4)
+
 /** Linked list of icon paths. */
 typedef struct IconPathNode {
    char *path;
@@ -34,31 +42,43 @@ typedef struct IconPathNode {
 
 static int iconSize = 0;
 static IconNode **iconHash;
+static IconNode **binaryHash;
 static IconPathNode *iconPaths;
 static IconPathNode *iconPathsTail;
 static GC iconGC;
 
 static void SetIconSize();
-static void DoDestroyIcon(int index, IconNode *icon);
-static void ReadNetWMIcon(ClientNode *np);
+static void DoDestroyIcon(IconNode *icon);
+static IconNode *ReadNetWMIcon(ClientNode *np);
+static IconNode *FindClientIcon(ClientNode *np);
 static IconNode *GetDefaultIcon();
 static IconNode *CreateIconFromData(const char *name, char **data);
 static IconNode *CreateIconFromFile(const char *fileName);
 static IconNode *CreateIconFromBinary(const unsigned long *data,
                                       unsigned int length);
+static unsigned int GetBinaryHash(const unsigned long *data,
+                                  unsigned long pixels);
+static int IsSameBinary(const IconNode *icon, const unsigned long *data,
+                        unsigned long pixels);
 static IconNode *LoadNamedIconHelper(const char *name, const char *path);
 
 static IconNode *LoadSuffixedIcon(const char *path, const char *name,
                                   const char *suffix);
 
 static ScaledIconNode *GetScaledIcon(IconNode *icon, int width, int height);
+static void ReleaseScaledIcon(void *object);
+static void FreeScaledIcon(ScaledIconNode *np);
 
 static void InsertIcon(IconNode *icon);
 static IconNode *FindIcon(const char *name);
+static void SetIconFile(IconNode *icon);
+static int IsIconCurrent(const IconNode *icon);
 static int GetHash(const char *str);
 
 /** Initialize icon data.
  * This must be initialized before parsing the configuration.
+ * The tables are only allocated once since icons are kept across
+ * a restart.
  */
 void InitializeIcons() {
 
@@ -67,9 +87,17 @@ void InitializeIcons() {
    iconPaths = NULL;
    iconPathsTail = NULL;
 
-   iconHash = Allocate(sizeof(IconNode*) * HASH_SIZE);
-   for(x = 0; x < HASH_SIZE; x++) {
-      iconHash[x] = NULL;
+   if(!iconHash) {
+      iconHash = Allocate(sizeof(IconNode*) * HASH_SIZE);
+      for(x = 0; x < HASH_SIZE; x++) {
+         iconHash[x] = NULL;
+      }
+   }
+   if(!binaryHash) {
+      binaryHash = Allocate(sizeof(IconNode*) * HASH_SIZE);
+      for(x = 0; x < HASH_SIZE; x++) {
+         binaryHash[x] = NULL;
+      }
    }
 
    memset(&emptyIcon, 0, sizeof(emptyIcon));
@@ -88,14 +116,32 @@ void StartupIcons() {
 
 }
 
-/** Shutdown icon support. */
+/** Shutdown icon support.
+ * When restarting, the decoded icons and their scaled pixmaps are kept
+ * since the connection to the X server stays open. Named icons are
+ * checked against their files the next time they are used and unused
+ * client icons are released by PurgeIcons.
+ */
 void ShutdownIcons() {
 
+   IconNode *icon;
    int x;
 
    for(x = 0; x < HASH_SIZE; x++) {
-      while(iconHash[x]) {
-         DoDestroyIcon(x, iconHash[x]);
+      if(shouldRestart) {
+         for(icon = iconHash[x]; icon; icon = icon->next) {
+            icon->retained = 1;
+         }
+         for(icon = binaryHash[x]; icon; icon = icon->next) {
+            icon->retained = 1;
+         }
+      } else {
+         while(iconHash[x]) {
+            DoDestroyIcon(iconHash[x]);
+         }
+         while(binaryHash[x]) {
+            DoDestroyIcon(binaryHash[x]);
+         }
       }
    }
 
@@ -116,10 +162,14 @@ void DestroyIcons() {
    }
    iconPathsTail = NULL;
 
-   if(iconHash) {
+   if(iconHash && !shouldRestart) {
       Release(iconHash);
       iconHash = NULL;
    }
+   if(binaryHash && !shouldRestart) {
+      Release(binaryHash);
+      binaryHash = NULL;
+   }
 }
 
 /** Set the preferred icon sizes on the root window. */
@@ -238,20 +288,30 @@ void PutIcon(IconNode *icon, Drawable d, int x, int y,
 /** Load the icon for a client. */
 void LoadIcon(ClientNode *np) {
 
-   IconPathNode *ip;
+   IconNode *icon;
 
    Assert(np);
 
    SetIconSize();
 
-   /* If client already has an icon, destroy it first. */
+   /* Look up the new icon before releasing the old one so that
+    * an unchanged _NET_WM_ICON reuses the decoded icon. */
+   icon = FindClientIcon(np);
    DestroyIcon(np->icon);
-   np->icon = NULL;
+   np->icon = icon;
+
+}
+
+/** Find the icon to use for a client. */
+IconNode *FindClientIcon(ClientNode *np) {
+
+   IconPathNode *ip;
+   IconNode *icon;
 
    /* Attempt to read _NET_WM_ICON for an icon */
-   ReadNetWMIcon(np);
-   if(np->icon) {
-      return;
+   icon = ReadNetWMIcon(np);
+   if(icon) {
+      return icon;
    }
 
    /* Attempt to find an icon for this program in the icon directory */
@@ -259,23 +319,23 @@ void LoadIcon(ClientNode *np) {
       for(ip = iconPaths; ip; ip = ip->next) {
 
 #ifdef USE_PNG
-         np->icon = LoadSuffixedIcon(ip->path, np->instanceName, ".png");
-         if(np->icon) {
-            return;
+         icon = LoadSuffixedIcon(ip->path, np->instanceName, ".png");
+         if(icon) {
+            return icon;
          }
 #endif
 
 #ifdef USE_XPM
-         np->icon = LoadSuffixedIcon(ip->path, np->instanceName, ".xpm");
-         if(np->icon) {
-            return;
+         icon = LoadSuffixedIcon(ip->path, np->instanceName, ".xpm");
+         if(icon) {
+            return icon;
          }
 #endif
 
 #ifdef USE_JPEG
-         np->icon = LoadSuffixedIcon(ip->path, np->instanceName, ".jpg");
-         if(np->icon) {
-            return;
+         icon = LoadSuffixedIcon(ip->path, np->instanceName, ".jpg");
+         if(icon) {
+            return icon;
          }
 #endif
 
@@ -283,7 +343,7 @@ void LoadIcon(ClientNode *np) {
    }
 
    /* Load the default icon */
-   np->icon = GetDefaultIcon();
+   return GetDefaultIcon();
 
 }
 
@@ -316,6 +376,7 @@ IconNode *LoadSuffixedIcon(const char *path, const char *name,
       result = CreateIcon();
       result->name = iconName;
       result->image = image;
+      SetIconFile(result);
       InsertIcon(result);
       return result;
    } else {
@@ -330,22 +391,27 @@ IconNode *LoadNamedIcon(const char *name) {
 
    IconPathNode *ip;
    IconNode *icon;
+   ProfileTime start;
 
    Assert(name);
 
    SetIconSize();
 
+   start = StartProfile();
    if(name[0] == '/') {
-      return CreateIconFromFile(name);
+      icon = CreateIconFromFile(name);
    } else {
+      icon = NULL;
       for(ip = iconPaths; ip; ip = ip->next) {
          icon = LoadNamedIconHelper(name, ip->path);
          if(icon) {
-            return icon;
+            break;
          }
       }
-      return NULL;
    }
+   StopProfile(PROFILE_LOAD_ICON, start);
+
+   return icon;
 
 }
 
@@ -365,25 +431,102 @@ IconNode *LoadNamedIconHelper(const char *name, const char *path) {
 
 }
 
-/** Read the icon property from a client. */
-void ReadNetWMIcon(ClientNode *np) {
+/** Read the icon property from a client.
+ * _NET_WM_ICON may contain several images. Only the width and height
+ * of each image are read to select the one closest to the icon size,
+ * then the pixel data of that image alone is fetched.
+ */
+IconNode *ReadNetWMIcon(ClientNode *np) {
 
+   IconNode *result;
    unsigned long count;
    int status;
    unsigned long extra;
    Atom realType;
    int realFormat;
    unsigned char *data;
+   unsigned long *header;
+   unsigned long width, height;
+   unsigned long pixels;
+   unsigned long offset;
+   unsigned long bestOffset, bestPixels;
+   unsigned long bestWidth, bestHeight;
+   int images;
+
+   bestPixels = 0;
+   bestOffset = 0;
+   bestWidth = 0;
+   bestHeight = 0;
+   offset = 0;
+   for(images = 0; images < MAX_NET_ICONS; images++) {
+
+      status = JXGetWindowProperty(display, np->window,
+         atoms[ATOM_NET_WM_ICON], offset, 2, False, XA_CARDINAL,
+         &realType, &realFormat, &count, &extra, &data);
+      if(status != Success || !data) {
+         break;
+      }
+      header = (unsigned long*)data;
+      if(realFormat != 32 || count < 2) {
+         JXFree(data);
+         break;
+      }
+      width = header[0];
+      height = header[1];
+      JXFree(data);
 
-   status = JXGetWindowProperty(display, np->window, atoms[ATOM_NET_WM_ICON],
-      0, 256 * 256 * 4, False, XA_CARDINAL, &realType, &realFormat, &count,
-      &extra, &data);
+      /* extra is the number of bytes following the header. */
+      if(JUNLIKELY(width == 0 || height == 0
+         || width > MAX_NET_ICON_PIXELS || height > MAX_NET_ICON_PIXELS)) {
+         break;
+      }
+      pixels = width * height;
+      if(JUNLIKELY(pixels > MAX_NET_ICON_PIXELS || pixels * 4 > extra)) {
+         break;
+      }
 
+      /* Prefer the smallest image at least as large as the icon size,
+       * otherwise the largest image available. */
+      if(bestPixels == 0) {
+         bestOffset = offset;
+      } else if(Min(bestWidth, bestHeight) < (unsigned long)iconSize) {
+         if(pixels > bestPixels) {
+            bestOffset = offset;
+         }
+      } else if(Min(width, height) >= (unsigned long)iconSize
+         && pixels < bestPixels) {
+         bestOffset = offset;
+      }
+      if(bestOffset == offset) {
+         bestPixels = pixels;
+         bestWidth = width;
+         bestHeight = height;
+      }
+
+      offset += 2 + pixels;
+      if(pixels * 4 == extra) {
+         break;
+      }
+
+   }
+
+   if(bestPixels == 0) {
+      return NULL;
+   }
+
+   result = NULL;
+   status = JXGetWindowProperty(display, np->window, atoms[ATOM_NET_WM_ICON],
+      bestOffset, 2 + bestPixels, False, XA_CARDINAL, &realType, &realFormat,
+      &count, &extra, &data);
    if(status == Success && data) {
-      np->icon = CreateIconFromBinary((unsigned long*)data, count);
+      if(realFormat == 32) {
+         result = CreateIconFromBinary((unsigned long*)data, count);
+      }
       JXFree(data);
    }
 
+   return result;
+
 }
 
 
@@ -441,6 +584,7 @@ IconNode *CreateIconFromFile(const char *fileName) {
       result = CreateIcon();
       result->name = CopyString(fileName);
       result->image = image;
+      SetIconFile(result);
       InsertIcon(result);
       return result;
    } else {
@@ -493,17 +637,25 @@ ScaledIconNode *GetScaledIcon(IconNode *icon, int rwidth, int rheight) {
       if(np->imagePicture != None) {
          np->width = nwidth;
          np->height = nheight;
+         TouchCacheEntry(np->cache);
          return np;
       }
 #endif
       if(np->width == nwidth && np->height == nheight) {
+         TouchCacheEntry(np->cache);
          return np;
       }
    }
 
-   /* See if we can use XRender to create the icon. */
+   /* See if we can use XRender to create the icon.
+    * The pixmaps are kept at the size of the image.
+    */
    np = CreateScaledRenderIcon(icon, nwidth, nheight);
    if(np) {
+      np->cache = AddCacheEntry(np,
+         GetPixmapSize(icon->image->width, icon->image->height, 8)
+         + GetPixmapSize(icon->image->width, icon->image->height, rootDepth),
+         ReleaseScaledIcon);
       return np;
    }
 
@@ -511,9 +663,11 @@ ScaledIconNode *GetScaledIcon(IconNode *icon, int rwidth, int rheight) {
    np = Allocate(sizeof(ScaledIconNode));
    np->width = nwidth;
    np->height = nheight;
+   np->icon = icon;
    np->next = icon->nodes;
 #ifdef USE_XRENDER
    np->imagePicture = None;
+   np->alphaPicture = None;
 #endif
    icon->nodes = np;
 
@@ -574,11 +728,59 @@ ScaledIconNode *GetScaledIcon(IconNode *icon, int rwidth, int rheight) {
    image->data = NULL;
    JXDestroyImage(image);
 
+   np->cache = AddCacheEntry(np,
+                             GetPixmapSize(nwidth, nheight, 1)
+                             + GetPixmapSize(nwidth, nheight, rootDepth),
+                             ReleaseScaledIcon);
+
    return np;
 
 }
 
-/** Create an icon from binary data (as specified via window properties). */
+/** Release a scaled icon evicted from the pixmap cache.
+ * It will be created again the next time it is drawn.
+ */
+void ReleaseScaledIcon(void *object) {
+
+   ScaledIconNode *np = (ScaledIconNode*)object;
+   ScaledIconNode **lp;
+
+   for(lp = &np->icon->nodes; *lp; lp = &(*lp)->next) {
+      if(*lp == np) {
+         *lp = np->next;
+         break;
+      }
+   }
+   FreeScaledIcon(np);
+
+}
+
+/** Free the pixmaps of a scaled icon and the node itself. */
+void FreeScaledIcon(ScaledIconNode *np) {
+
+#ifdef USE_XRENDER
+   if(np->imagePicture != None) {
+      JXRenderFreePicture(display, np->imagePicture);
+   }
+   if(np->alphaPicture != None) {
+      JXRenderFreePicture(display, np->alphaPicture);
+   }
+#endif
+
+   if(np->image != None) {
+      JXFreePixmap(display, np->image);
+   }
+   if(np->mask != None) {
+      JXFreePixmap(display, np->mask);
+   }
+
+   Release(np);
+
+}
+
+/** Create an icon from binary data (as specified via window properties).
+ * Icons with the same content are shared and reference counted.
+ */
 IconNode *CreateIconFromBinary(const unsigned long *input,
    unsigned int length) {
 
@@ -586,6 +788,8 @@ IconNode *CreateIconFromBinary(const unsigned long *input,
    IconNode *result;
    unsigned char *data;
    unsigned int x, index;
+   unsigned int hash;
+   unsigned int bucket;
 
    if(!input) {
       return NULL;
@@ -602,7 +806,21 @@ IconNode *CreateIconFromBinary(const unsigned long *input,
       return NULL;
    }
 
+   /* Check if an icon with this content already exists. */
+   hash = GetBinaryHash(input, width * height + 2);
+   bucket = hash & (HASH_SIZE - 1);
+   for(result = binaryHash[bucket]; result; result = result->next) {
+      if(result->hash == hash
+         && IsSameBinary(result, input, width * height)) {
+         result->refCount += 1;
+         result->retained = 0;
+         return result;
+      }
+   }
+
    result = CreateIcon();
+   result->hash = hash;
+   result->refCount = 1;
 
    result->image = Allocate(sizeof(ImageNode));
    result->image->width = width;
@@ -620,12 +838,61 @@ IconNode *CreateIconFromBinary(const unsigned long *input,
       data[index++] = input[x + 2] & 0xFF;
    }
 
-   /* Don't insert this icon since it is transient. */
+   /* Insert this icon in the content hash. */
+   result->prev = NULL;
+   if(binaryHash[bucket]) {
+      binaryHash[bucket]->prev = result;
+   }
+   result->next = binaryHash[bucket];
+   binaryHash[bucket] = result;
 
    return result;
 
 }
 
+/** Get the content hash for _NET_WM_ICON data (including the size). */
+unsigned int GetBinaryHash(const unsigned long *data,
+                           unsigned long length) {
+
+   unsigned long x;
+   unsigned int hash = 2166136261U;
+
+   for(x = 0; x < length; x++) {
+      hash = (hash ^ (unsigned int)(data[x] & 0xFFFFFFFF)) * 16777619U;
+   }
+
+   return hash;
+
+}
+
+/** Determine if an icon contains the specified _NET_WM_ICON data. */
+int IsSameBinary(const IconNode *icon, const unsigned long *input,
+                 unsigned long pixels) {
+
+   const unsigned char *data;
+   unsigned long x;
+   unsigned long value;
+
+   if(icon->image->width != input[0] || icon->image->height != input[1]) {
+      return 0;
+   }
+
+   data = icon->image->data;
+   for(x = 0; x < pixels; x++) {
+      value = ((unsigned long)data[0] << 24)
+            | ((unsigned long)data[1] << 16)
+            | ((unsigned long)data[2] << 8)
+            | (unsigned long)data[3];
+      if(value != (input[x + 2] & 0xFFFFFFFF)) {
+         return 0;
+      }
+      data += 4;
+   }
+
+   return 1;
+
+}
+
 /** Create an empty icon node. */
 IconNode *CreateIcon() {
 
@@ -636,6 +903,11 @@ IconNode *CreateIcon() {
    icon->image = NULL;
    icon->nodes = NULL;
    icon->useRender = 1;
+   icon->hash = 0;
+   icon->refCount = 0;
+   icon->modified = 0;
+   icon->fileSize = 0;
+   icon->retained = 0;
    icon->next = NULL;
    icon->prev = NULL;
 
@@ -644,41 +916,31 @@ IconNode *CreateIcon() {
 }
 
 /** Helper method for destroy icons. */
-void DoDestroyIcon(int index, IconNode *icon) {
+void DoDestroyIcon(IconNode *icon) {
 
    ScaledIconNode *np;
 
    if(icon) {
       while(icon->nodes) {
          np = icon->nodes->next;
-
-#ifdef USE_XRENDER
-         if(icon->nodes->imagePicture != None) {
-            JXRenderFreePicture(display, icon->nodes->imagePicture);
-         }
-#endif
-
-         if(icon->nodes->image != None) {
-            JXFreePixmap(display, icon->nodes->image);
-         }
-         if(icon->nodes->mask != None) {
-            JXFreePixmap(display, icon->nodes->mask);
-         }
-
-         Release(icon->nodes);
+         RemoveCacheEntry(icon->nodes->cache);
+         FreeScaledIcon(icon->nodes);
          icon->nodes = np;
       }
 
+      if(icon->prev) {
+         icon->prev->next = icon->next;
+      } else if(icon->name) {
+         iconHash[GetHash(icon->name)] = icon->next;
+      } else {
+         binaryHash[icon->hash & (HASH_SIZE - 1)] = icon->next;
+      }
+
       if(icon->name) {
          Release(icon->name);
       }
       DestroyImage(icon->image);
 
-      if(icon->prev) {
-         icon->prev->next = icon->next;
-      } else {
-         iconHash[index] = icon->next;
-      }
       if(icon->next) {
          icon->next->prev = icon->prev;
       }
@@ -686,14 +948,37 @@ void DoDestroyIcon(int index, IconNode *icon) {
    }
 }
 
-/** Destroy an icon. */
+/** Destroy an icon.
+ * Unused client icons are kept while restarting so that clients with
+ * the same _NET_WM_ICON can pick them up again.
+ */
 void DestroyIcon(IconNode *icon) {
 
-   int index;
+   if(icon && icon != &emptyIcon && !icon->name) {
+      icon->refCount -= 1;
+      if(icon->refCount <= 0 && !shouldRestart) {
+         DoDestroyIcon(icon);
+      }
+   }
+
+}
+
+/** Release icons kept across a restart that are no longer used. */
+void PurgeIcons() {
+
+   IconNode *icon;
+   IconNode *next;
+   int x;
 
-   if(icon && !icon->name) {
-      index = GetHash(icon->name);
-      DoDestroyIcon(index, icon);
+   for(x = 0; x < HASH_SIZE; x++) {
+      icon = binaryHash[x];
+      while(icon) {
+         next = icon->next;
+         if(icon->refCount <= 0) {
+            DoDestroyIcon(icon);
+         }
+         icon = next;
+      }
    }
 
 }
@@ -728,6 +1013,13 @@ IconNode *FindIcon(const char *name) {
    icon = iconHash[index];
    while(icon) {
       if(!strcmp(icon->name, name)) {
+         if(icon->retained) {
+            if(!IsIconCurrent(icon)) {
+               DoDestroyIcon(icon);
+               return NULL;
+            }
+            icon->retained = 0;
+         }
          return icon;
       }
       icon = icon->next;
@@ -737,6 +1029,36 @@ IconNode *FindIcon(const char *name) {
 
 }
 
+/** Remember the time and size of the file an icon was loaded from. */
+void SetIconFile(IconNode *icon) {
+
+   struct stat sbuf;
+
+   if(stat(icon->name, &sbuf) == 0) {
+      icon->modified = sbuf.st_mtime;
+      icon->fileSize = sbuf.st_size;
+   }
+
+}
+
+/** Determine if the file of an icon kept across a restart is unchanged.
+ * Icons created from built-in data have no file and are always current.
+ */
+int IsIconCurrent(const IconNode *icon) {
+
+   struct stat sbuf;
+
+   if(icon->modified == 0) {
+      return 1;
+   }
+   if(stat(icon->name, &sbuf) != 0) {
+      return 0;
+   }
+   return sbuf.st_mtime == icon->modified
+       && sbuf.st_size == icon->fileSize;
+
+}
+
 /** Get the hash for a string. */
 int GetHash(const char *str) {
 
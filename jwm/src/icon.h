@@ -11,6 +11,7 @@
 #define ICON_H
 
 struct ClientNode;
+struct CacheEntry;
 
 /** Structure to hold a scaled icon. */
 typedef struct ScaledIconNode {
@@ -25,6 +26,8 @@ typedef struct ScaledIconNode {
    Picture alphaPicture;
 #endif
 
+   struct IconNode *icon;        /**< The icon this is a version of. */
+   struct CacheEntry *cache;     /**< Entry in the pixmap cache. */
    struct ScaledIconNode *next;
 
 } ScaledIconNode;
@@ -36,6 +39,11 @@ typedef struct IconNode {
    struct ImageNode *image;       /**< The image data. */
    struct ScaledIconNode *nodes;  /**< Scaled versions of the icon. */
 	int useRender;						 /**< 1 if render can be used. */
+   unsigned int hash;             /**< Content hash (unnamed icons). */
+   int refCount;                  /**< References (unnamed icons). */
+   time_t modified;               /**< File time (named icons). */
+   off_t fileSize;                /**< File size (named icons). */
+   char retained;                 /**< Kept from before a restart. */
    
    struct IconNode *next;         /**< The next icon in the list. */
    struct IconNode *prev;         /**< The previous icon in the list. */
@@ -84,10 +92,17 @@ void LoadIcon(struct ClientNode *np);
 IconNode *LoadNamedIcon(const char *name);
 
 /** Destroy an icon.
+ * Named icons are cached until shutdown. Icons read from _NET_WM_ICON
+ * are shared by content and released with their last reference.
  * @param icon The icon to destroy.
  */
 void DestroyIcon(IconNode *icon);
 
+/** Release icons kept across a restart that are no longer used.
+ * This is called once the clients have been managed again.
+ */
+void PurgeIcons();
+
 /** Create and initialize a new icon structure.
  * @return The new icon structure.
  */
@@ -106,6 +121,7 @@ IconNode *CreateIcon();
 #define LoadIcon( a )                   ICON_DUMMY_FUNCTION
 #define LoadNamedIcon( a )              ICON_DUMMY_FUNCTION
 #define DestroyIcon( a )                ICON_DUMMY_FUNCTION
+#define PurgeIcons()                    ICON_DUMMY_FUNCTION
 
 #endif /* USE_ICONS */
 
@@ -18,6 +18,7 @@
 #  include <stdlib.h>
 #  include <ctype.h>
 #  include <limits.h>
+#  include <errno.h>
 
    /* Ideally png.h would be included in image.c, which is the only
     * file that references it. Unfortunately, if setjmp.h is included
@@ -34,6 +35,9 @@
 #  ifdef HAVE_LOCALE_H
 #     include <locale.h>
 #  endif
+#  ifdef HAVE_MALLOC_H
+#     include <malloc.h>
+#  endif
 #  ifdef HAVE_LIBINTL_H
 #     include <libintl.h>
 #  endif
@@ -55,9 +59,23 @@
 #  ifdef HAVE_SYS_TIME_H
 #     include <sys/time.h>
 #  endif
+#  ifdef HAVE_SYS_STAT_H
+#     include <sys/stat.h>
+#  endif
 #  ifdef HAVE_SYS_SELECT_H
 #     include <sys/select.h>
 #  endif
+#  ifdef HAVE_FCNTL_H
+#     include <fcntl.h>
+#  endif
+#  ifdef HAVE_SPAWN_H
+#     include <spawn.h>
+#  endif
+#  if defined(HAVE_SYS_SOCKET_H) && defined(HAVE_SYS_UN_H)
+#     include <sys/socket.h>
+#     include <sys/un.h>
+#     define USE_CONTROL
+#  endif
 
 #  include <X11/Xlib.h>
 #  ifdef HAVE_X11_XUTIL_H
@@ -78,11 +96,18 @@
 #  ifdef HAVE_X11_KEYSYM_H
 #     include <X11/keysym.h>
 #  endif
+#  ifdef USE_XCB
+#     include <X11/Xlib-xcb.h>
+#  endif
 
 #  ifdef USE_SHAPE
 #     include <X11/extensions/shape.h>
 #  endif
 
+#  ifdef USE_XSYNC
+#     include <X11/extensions/sync.h>
+#  endif
+
 #  ifdef USE_XMU
 #     include <X11/Xmu/Xmu.h>
 #  endif
@@ -174,6 +199,8 @@
 #endif
 
 #include "debug.h"
+#include "resource.h"
+#include "request.h"
 #include "jxlib.h"
 
 #endif /* JWM_H */
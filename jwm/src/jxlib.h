@@ -5,22 +5,28 @@
  *
  * @brief Macros to wrap X calls for debugging.
  *
+ * Calls that create or free server resources also keep the accounting
+ * in resource.c up to date.
+ *
  */
 
 #ifndef JXLIB_H
 #define JXLIB_H
 
+/** Number of requests that waited for a reply from the server. */
+extern unsigned long roundTripCount;
+
 #define JXAddToSaveSet( a, b ) \
    ( SetCheckpoint(), XAddToSaveSet( a, b ) )
 
 #define JXAllocColor( a, b, c ) \
-   ( SetCheckpoint(), XAllocColor( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XAllocColor( a, b, c ) )
 
 #define JXGetRGBColormaps( a, b, c, d, e ) \
-   ( SetCheckpoint(), XGetRGBColormaps( a, b, c, d, e ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetRGBColormaps( a, b, c, d, e ) )
 
 #define JXQueryColor( a, b, c ) \
-   ( SetCheckpoint(), XQueryColor( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XQueryColor( a, b, c ) )
 
 #define JXAllowEvents( a, b, c ) \
    ( SetCheckpoint(), XAllowEvents( a, b, c ) )
@@ -40,6 +46,9 @@
 #define JXCheckTypedWindowEvent( a, b, c, d ) \
    ( SetCheckpoint(), XCheckTypedWindowEvent( a, b, c, d ) )
 
+#define JXClearArea( a, b, c, d, e, f, g ) \
+   ( SetCheckpoint(), XClearArea( a, b, c, d, e, f, g ) )
+
 #define JXClearWindow( a, b ) \
    ( SetCheckpoint(), XClearWindow( a, b ) )
 
@@ -59,10 +68,17 @@
    ( SetCheckpoint(), XCopyPlane( a, b, c, d, e, f, g, h, i, j, k ) )
 
 #define JXCreateFontCursor( a, b ) \
-   ( SetCheckpoint(), XCreateFontCursor( a, b ) )
+   ( \
+      SetCheckpoint(), \
+      (Cursor)TrackResource( RESOURCE_CURSOR, \
+                             XCreateFontCursor( a, b ), __FILE__ ) \
+   )
 
 #define JXCreateGC( a, b, c, d ) \
-   ( SetCheckpoint(), XCreateGC( a, b, c, d ) )
+   ( \
+      SetCheckpoint(), \
+      (GC)TrackPointer( RESOURCE_GC, XCreateGC( a, b, c, d ), __FILE__ ) \
+   )
 
 #define JXCreateImage( a, b, c, d, e, f, g, h, i, j ) \
    ( \
@@ -71,27 +87,29 @@
    )
 
 #define JXCreatePixmap( a, b, c, d, e ) \
-   ( SetCheckpoint(), XCreatePixmap( a, b, c, d, e ) )
+   ( SetCheckpoint(), CreateTrackedPixmap( a, b, c, d, e, __FILE__ ) )
 
 #define JXCreatePixmapFromBitmapData( a, b, c, d, e, f, g, h ) \
    ( \
       SetCheckpoint(), \
-      XCreatePixmapFromBitmapData( a, b, c, d, e, f, g, h ) \
+      CreateTrackedPixmapFromBitmap( a, b, c, d, e, f, g, h, __FILE__ ) \
    )
 
 #define JXCreateBitmapFromData( a, b, c, d, e ) \
-   ( SetCheckpoint(), XCreateBitmapFromData( a, b, c, d, e ) )
+   ( SetCheckpoint(), CreateTrackedBitmap( a, b, c, d, e, __FILE__ ) )
 
 #define JXCreateSimpleWindow( a, b, c, d, e, f, g, h, i ) \
    ( \
       SetCheckpoint(), \
-      XCreateSimpleWindow( a, b, c, d, e, f, g, h, i ) \
+      (Window)TrackResource( RESOURCE_WINDOW, \
+         XCreateSimpleWindow( a, b, c, d, e, f, g, h, i ), __FILE__ ) \
    )
 
 #define JXCreateWindow( a, b, c, d, e, f, g, h, i, j, k, l ) \
    ( \
       SetCheckpoint(), \
-      XCreateWindow( a, b, c, d, e, f, g, h, i, j, k, l ) \
+      (Window)TrackResource( RESOURCE_WINDOW, \
+         XCreateWindow( a, b, c, d, e, f, g, h, i, j, k, l ), __FILE__ ) \
    )
 
 #define JXDefineCursor( a, b, c ) \
@@ -101,7 +119,10 @@
    ( SetCheckpoint(), XDestroyImage( a ) )
 
 #define JXDestroyWindow( a, b ) \
-   ( SetCheckpoint(), XDestroyWindow( a, b ) )
+   ( \
+      SetCheckpoint(), \
+      XDestroyWindow( a, UntrackResource( RESOURCE_WINDOW, b ) ) \
+   )
 
 #define JXDrawPoint( a, b, c, d, e ) \
    ( SetCheckpoint(), XDrawPoint( a, b, c, d, e ) )
@@ -128,7 +149,7 @@
    ( SetCheckpoint(), XDrawString( a, b, c, d, e, f, g ) )
 
 #define JXFetchName( a, b, c ) \
-   ( SetCheckpoint(), XFetchName( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XFetchName( a, b, c ) )
 
 #define JXFillRectangle( a, b, c, d, e, f, g ) \
    ( SetCheckpoint(), XFillRectangle( a, b, c, d, e, f, g ) )
@@ -143,47 +164,51 @@
    ( SetCheckpoint(), XFreeColors( a, b, c, d, e ) )
 
 #define JXFreeCursor( a, b ) \
-   ( SetCheckpoint(), XFreeCursor( a, b ) )
+   ( SetCheckpoint(), XFreeCursor( a, UntrackResource( RESOURCE_CURSOR, b ) ) )
 
 #define JXFreeFont( a, b ) \
-   ( SetCheckpoint(), XFreeFont( a, b ) )
+   ( \
+      SetCheckpoint(), \
+      XFreeFont( a, (XFontStruct*)UntrackPointer( RESOURCE_FONT, b ) ) \
+   )
 
 #define JXFreeGC( a, b ) \
-   ( SetCheckpoint(), XFreeGC( a, b ) )
+   ( SetCheckpoint(), XFreeGC( a, (GC)UntrackPointer( RESOURCE_GC, b ) ) )
 
 #define JXFreeModifiermap( a ) \
    ( SetCheckpoint(), XFreeModifiermap( a ) )
 
 #define JXFreePixmap( a, b ) \
-   ( SetCheckpoint(), XFreePixmap( a, b ) )
+   ( SetCheckpoint(), XFreePixmap( a, UntrackResource( RESOURCE_PIXMAP, b ) ) )
 
 #define JXGetAtomName( a, b ) \
-   ( SetCheckpoint(), XGetAtomName( a, b ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetAtomName( a, b ) )
 
 #define JXGetModifierMapping( a ) \
-   ( SetCheckpoint(), XGetModifierMapping( a ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetModifierMapping( a ) )
 
 #define JXGetSubImage( a, b, c, d, e, f, g, h, i, j, k ) \
-   ( SetCheckpoint(), XGetSubImage( a, b, c, d, e, f, g, h, i, j, k ) )
+   ( SetCheckpoint(), ++roundTripCount, \
+   XGetSubImage( a, b, c, d, e, f, g, h, i, j, k ) )
 
 #define JXGetTransientForHint( a, b, c ) \
-   ( SetCheckpoint(), XGetTransientForHint( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetTransientForHint( a, b, c ) )
 
 #define JXGetClassHint( a, b, c ) \
-   ( SetCheckpoint(), XGetClassHint( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetClassHint( a, b, c ) )
 
 #define JXGetWindowAttributes( a, b, c ) \
-   ( SetCheckpoint(), XGetWindowAttributes( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetWindowAttributes( a, b, c ) )
 
 #define JXGetWindowProperty( a, b, c, d, e, f, g, h, i, j, k, l ) \
-   ( SetCheckpoint(), \
+   ( SetCheckpoint(), ++roundTripCount, \
    XGetWindowProperty( a, b, c, d, e, f, g, h, i, j, k, l ) )
 
 #define JXGetWMColormapWindows( a, b, c, d ) \
-   ( SetCheckpoint(), XGetWMColormapWindows( a, b, c, d ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetWMColormapWindows( a, b, c, d ) )
 
 #define JXGetWMNormalHints( a, b, c, d ) \
-   ( SetCheckpoint(), XGetWMNormalHints( a, b, c, d ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetWMNormalHints( a, b, c, d ) )
 
 #define JXSetIconSizes( a, b, c, d ) \
    ( SetCheckpoint(), XSetIconSizes( a, b, c, d ) )
@@ -192,7 +217,7 @@
    ( SetCheckpoint(), XSetWindowBorder( a, b, c ) )
 
 #define JXGetWMHints( a, b ) \
-   ( SetCheckpoint(), XGetWMHints( a, b ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetWMHints( a, b ) )
 
 #define JXGrabButton( a, b, c, d, e, f, g, h, i, j ) \
    ( SetCheckpoint(), XGrabButton( a, b, c, d, e, f, g, h, i, j ) )
@@ -207,10 +232,11 @@
    ( SetCheckpoint(), XUngrabKey( a, b, c, d ) )
 
 #define JXGrabKeyboard( a, b, c, d, e, f ) \
-   ( SetCheckpoint(), XGrabKeyboard( a, b, c, d, e, f ) )
+   ( SetCheckpoint(), ++roundTripCount, XGrabKeyboard( a, b, c, d, e, f ) )
 
 #define JXGrabPointer( a, b, c, d, e, f, g, h, i ) \
-   ( SetCheckpoint(), XGrabPointer( a, b, c, d, e, f, g, h, i ) )
+   ( SetCheckpoint(), ++roundTripCount, \
+   XGrabPointer( a, b, c, d, e, f, g, h, i ) )
 
 #define JXGrabServer( a ) \
    ( SetCheckpoint(), XGrabServer( a ) )
@@ -219,7 +245,13 @@
    ( SetCheckpoint(), XInstallColormap( a, b ) )
 
 #define JXInternAtom( a, b, c ) \
-   ( SetCheckpoint(), XInternAtom( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XInternAtom( a, b, c ) )
+
+#define JXInternAtoms( a, b, c, d, e ) \
+   ( SetCheckpoint(), ++roundTripCount, XInternAtoms( a, b, c, d, e ) )
+
+#define JXQueryColors( a, b, c, d ) \
+   ( SetCheckpoint(), ++roundTripCount, XQueryColors( a, b, c, d ) )
 
 #define JXKeysymToKeycode( a, b ) \
    ( SetCheckpoint(), XKeysymToKeycode( a, b ) )
@@ -228,7 +260,17 @@
    ( SetCheckpoint(), XKillClient( a, b ) )
 
 #define JXLoadQueryFont( a, b ) \
-   ( SetCheckpoint(), XLoadQueryFont( a, b ) )
+   ( \
+      SetCheckpoint(), ++roundTripCount, \
+      (XFontStruct*)TrackPointer( RESOURCE_FONT, \
+                                  XLoadQueryFont( a, b ), __FILE__ ) \
+   )
+
+#define JXLookupString( a, b, c, d, e ) \
+   ( SetCheckpoint(), XLookupString( a, b, c, d, e ) )
+
+#define JXLowerWindow( a, b ) \
+   ( SetCheckpoint(), XLowerWindow( a, b ) )
 
 #define JXMapRaised( a, b ) \
    ( SetCheckpoint(), XMapRaised( a, b ) )
@@ -255,7 +297,7 @@
    ( SetCheckpoint(), XOpenDisplay( a ) )
 
 #define JXParseColor( a, b, c, d ) \
-   ( SetCheckpoint(), XParseColor( a, b, c, d ) )
+   ( SetCheckpoint(), ++roundTripCount, XParseColor( a, b, c, d ) )
 
 #define JXPending( a ) \
    ( SetCheckpoint(), XPending( a ) )
@@ -264,16 +306,45 @@
    ( SetCheckpoint(), XPutBackEvent( a, b ) )
 
 #define JXGetImage( a, b, c, d, e, f, g, h ) \
-   ( SetCheckpoint(), XGetImage( a, b, c, d, e, f, g, h ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetImage( a, b, c, d, e, f, g, h ) )
 
 #define JXPutImage( a, b, c, d, e, f, g, h, i, j ) \
    ( SetCheckpoint(), XPutImage( a, b, c, d, e, f, g, h, i, j ) )
 
 #define JXQueryPointer( a, b, c, d, e, f, g, h, i ) \
-   ( SetCheckpoint(), XQueryPointer( a, b, c, d, e, f, g, h, i ) )
+   ( SetCheckpoint(), ++roundTripCount, \
+   XQueryPointer( a, b, c, d, e, f, g, h, i ) )
 
 #define JXQueryTree( a, b, c, d, e, f ) \
-   ( SetCheckpoint(), XQueryTree( a, b, c, d, e, f ) )
+   ( SetCheckpoint(), ++roundTripCount, XQueryTree( a, b, c, d, e, f ) )
+
+/* Requests with replies that are collected later (see request.h).
+ * Round trips are counted in request.c since that depends on whether
+ * the replies arrive together. */
+
+#define JXRequestProperty( a, b, c, d, e, f, g ) \
+   ( SetCheckpoint(), RequestProperty( a, b, c, d, e, f, g ) )
+
+#define JXReceiveProperty( a, b, c, d, e, f, g ) \
+   ( SetCheckpoint(), ReceiveProperty( a, b, c, d, e, f, g ) )
+
+#define JXRequestWindowAttributes( a, b, c ) \
+   ( SetCheckpoint(), RequestWindowAttributes( a, b, c ) )
+
+#define JXReceiveWindowAttributes( a, b, c ) \
+   ( SetCheckpoint(), ReceiveWindowAttributes( a, b, c ) )
+
+#define JXRequestPointer( a, b, c ) \
+   ( SetCheckpoint(), RequestPointer( a, b, c ) )
+
+#define JXReceivePointer( a, b, c, d, e, f, g, h, i ) \
+   ( SetCheckpoint(), ReceivePointer( a, b, c, d, e, f, g, h, i ) )
+
+#define JXRequestTree( a, b, c ) \
+   ( SetCheckpoint(), RequestTree( a, b, c ) )
+
+#define JXReceiveTree( a, b, c, d, e, f ) \
+   ( SetCheckpoint(), ReceiveTree( a, b, c, d, e, f ) )
 
 #define JXReparentWindow( a, b, c, d, e ) \
    ( SetCheckpoint(), XReparentWindow( a, b, c, d, e ) )
@@ -320,6 +391,9 @@
 #define JXSetWindowBackground( a, b, c ) \
    ( SetCheckpoint(), XSetWindowBackground( a, b, c ) )
 
+#define JXSetWindowBackgroundPixmap( a, b, c ) \
+   ( SetCheckpoint(), XSetWindowBackgroundPixmap( a, b, c ) )
+
 #define JXSetWindowBorderWidth( a, b, c ) \
    ( SetCheckpoint(), XSetWindowBorderWidth( a, b, c ) )
 
@@ -336,18 +410,36 @@
    ( SetCheckpoint(), XShapeCombineMask( a, b, c, d, e, f, g ) )
 
 #define JXShapeQueryExtension( a, b, c ) \
-   ( SetCheckpoint(), XShapeQueryExtension( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XShapeQueryExtension( a, b, c ) )
 
 #define JXQueryExtension( a, b, c, d, e ) \
-   ( SetCheckpoint(), XQueryExtension( a, b, c, d, e ) )
+   ( SetCheckpoint(), ++roundTripCount, XQueryExtension( a, b, c, d, e ) )
 
 #define JXShapeQueryExtents( a, b, c, d, e, f, g, h, i, j, k, l ) \
    ( SetCheckpoint(), \
-   XShapeQueryExtents( a, b, c, d, e, f, g, h, i, j, k, l ) )
+   ++roundTripCount, XShapeQueryExtents( a, b, c, d, e, f, g, h, i, j, k, l ) )
 
 #define JXShapeSelectInput( a, b, c ) \
    ( SetCheckpoint(), XShapeSelectInput( a, b, c ) )
 
+#define JXSyncQueryExtension( a, b, c ) \
+   ( SetCheckpoint(), ++roundTripCount, XSyncQueryExtension( a, b, c ) )
+
+#define JXSyncInitialize( a, b, c ) \
+   ( SetCheckpoint(), ++roundTripCount, XSyncInitialize( a, b, c ) )
+
+#define JXSyncQueryCounter( a, b, c ) \
+   ( SetCheckpoint(), ++roundTripCount, XSyncQueryCounter( a, b, c ) )
+
+#define JXSyncCreateAlarm( a, b, c ) \
+   ( SetCheckpoint(), XSyncCreateAlarm( a, b, c ) )
+
+#define JXSyncChangeAlarm( a, b, c, d ) \
+   ( SetCheckpoint(), XSyncChangeAlarm( a, b, c, d ) )
+
+#define JXSyncDestroyAlarm( a, b ) \
+   ( SetCheckpoint(), XSyncDestroyAlarm( a, b ) )
+
 #define JXStoreName( a, b, c ) \
    ( SetCheckpoint(), XStoreName( a, b, c ) )
 
@@ -355,7 +447,7 @@
    ( SetCheckpoint(), XStringToKeysym( a ) )
 
 #define JXSync( a, b ) \
-   ( SetCheckpoint(), XSync( a, b ) )
+   ( SetCheckpoint(), ++roundTripCount, XSync( a, b ) )
 
 #define JXTextWidth( a, b, c ) \
    ( SetCheckpoint(), XTextWidth( a, b, c ) )
@@ -382,15 +474,23 @@
    ( SetCheckpoint(), XSetSelectionOwner( a, b, c, d ) )
 
 #define JXGetSelectionOwner( a, b ) \
-   ( SetCheckpoint(), XGetSelectionOwner( a, b ) )
+   ( SetCheckpoint(), ++roundTripCount, XGetSelectionOwner( a, b ) )
 
 /* XFT */
 
 #define JXftFontOpenName( a, b, c ) \
-   ( SetCheckpoint(), XftFontOpenName( a, b, c ) )
+   ( \
+      SetCheckpoint(), \
+      (XftFont*)TrackPointer( RESOURCE_FONT, \
+                              XftFontOpenName( a, b, c ), __FILE__ ) \
+   )
 
 #define JXftFontOpenXlfd( a, b, c ) \
-   ( SetCheckpoint(), XftFontOpenXlfd( a, b, c ) )
+   ( \
+      SetCheckpoint(), \
+      (XftFont*)TrackPointer( RESOURCE_FONT, \
+                              XftFontOpenXlfd( a, b, c ), __FILE__ ) \
+   )
 
 #define JXftDrawCreate( a, b, c, d ) \
    ( SetCheckpoint(), XftDrawCreate( a, b, c, d ) )
@@ -417,12 +517,15 @@
    ( SetCheckpoint(), XftColorAllocValue( a, b, c, d, e ) )
 
 #define JXftFontClose( a, b ) \
-   ( SetCheckpoint(), XftFontClose( a, b ) )
+   ( \
+      SetCheckpoint(), \
+      XftFontClose( a, (XftFont*)UntrackPointer( RESOURCE_FONT, b ) ) \
+   )
 
 /* Xrender */
 
 #define JXRenderQueryExtension( a, b, c ) \
-   ( SetCheckpoint(), XRenderQueryExtension( a, b, c ) )
+   ( SetCheckpoint(), ++roundTripCount, XRenderQueryExtension( a, b, c ) )
 
 #define JXRenderFindVisualFormat( a, b ) \
    ( SetCheckpoint(), XRenderFindVisualFormat( a, b ) )
@@ -434,10 +537,17 @@
    ( SetCheckpoint(), XRenderFindStandardFormat( a, b ) )
 
 #define JXRenderCreatePicture( a, b, c, d, e ) \
-   ( SetCheckpoint(), XRenderCreatePicture( a, b, c, d, e ) )
+   ( \
+      SetCheckpoint(), \
+      (Picture)TrackResource( RESOURCE_PICTURE, \
+         XRenderCreatePicture( a, b, c, d, e ), __FILE__ ) \
+   )
 
 #define JXRenderFreePicture( a, b ) \
-   ( SetCheckpoint(), XRenderFreePicture( a, b ) )
+   ( \
+      SetCheckpoint(), \
+      XRenderFreePicture( a, UntrackResource( RESOURCE_PICTURE, b ) ) \
+   )
 
 #define JXRenderComposite( a, b, c, d, e, f, g, h, i, j, k, l, m ) \
    ( SetCheckpoint(), \
@@ -95,6 +95,7 @@ void StartupKeys() {
    XModifierKeymap *modmap;
    KeyNode *np;
    TrayType *tp;
+   ClientNode *cp;
    int x;
 
 
@@ -129,6 +130,12 @@ void StartupKeys() {
 
    }
 
+   /* Grab on clients that are already managed (after a reload). */
+   for(x = 0; x < LAYER_COUNT; x++) {
+      for(cp = nodes[x]; cp; cp = cp->next) {
+         GrabKeys(cp);
+      }
+   }
 
 }
 
@@ -64,6 +64,8 @@ static const char *TOKEN_MAP[] = {
    "Outline",
    "Pager",
    "PagerStyle",
+   "PixmapCacheSize",
+   "PlacementMode",
    "Popup",
    "PopupStyle",
    "Program",
@@ -95,6 +97,8 @@ static const char *TOKEN_MAP[] = {
 
 static TokenNode *head, *current;
 
+unsigned int syntaxErrorCount = 0;
+
 static TokenNode *CreateNode(TokenNode *parent, const char *file, int line);
 static AttributeNode *CreateAttribute(TokenNode *np); 
 
@@ -184,11 +188,13 @@ TokenNode *Tokenize(const char *line, const char *fileName) {
                              "match open tag \"%s\""),
                              fileName, lineNumber, temp,
                              GetTokenName(current));
+                     syntaxErrorCount += 1;
                   }
 
                } else {
                   Warning(_("%s[%d]: unexpected and invalid close tag"),
                           fileName, lineNumber);
+                  syntaxErrorCount += 1;
                }
 
                current = current->parent;
@@ -196,8 +202,10 @@ TokenNode *Tokenize(const char *line, const char *fileName) {
                if(temp) {
                   Warning(_("%s[%d]: close tag \"%s\" without open tag"),
                           fileName, lineNumber, temp);
+                  syntaxErrorCount += 1;
                } else {
                   Warning(_("%s[%d]: invalid close tag"), fileName, lineNumber);
+                  syntaxErrorCount += 1;
                }
             }
 
@@ -217,6 +225,7 @@ TokenNode *Tokenize(const char *line, const char *fileName) {
                Release(temp);
             } else {
                Warning(_("%s[%d]: invalid open tag"), fileName, lineNumber);
+               syntaxErrorCount += 1;
             }
          }
          inElement = 1;
@@ -230,6 +239,7 @@ TokenNode *Tokenize(const char *line, const char *fileName) {
                inElement = 0;
             } else {
                Warning(_("%s[%d]: invalid tag"), fileName, lineNumber);
+               syntaxErrorCount += 1;
             }
          } else {
             goto ReadDefault;
@@ -278,6 +288,7 @@ ReadDefault:
                   if(JUNLIKELY(temp[0])) {
                      Warning(_("%s[%d]: unexpected text: \"%s\""),
                              fileName, lineNumber, temp);
+                     syntaxErrorCount += 1;
                   }
                   Release(temp);
                }
@@ -287,6 +298,13 @@ ReadDefault:
       }
    }
 
+   /* A file cut short leaves tags open. */
+   if(JUNLIKELY(current)) {
+      Warning(_("%s[%d]: close tag \"%s\" missing"),
+              fileName, lineNumber, GetTokenName(current));
+      syntaxErrorCount += 1;
+   }
+
    return head;
 }
 
@@ -323,6 +341,7 @@ int ParseEntity(const char *entity, char *ch, const char *file, int line) {
       strncpy(temp, entity, x + 1);
       temp[x + 1] = 0;
       Warning(_("%s[%d]: invalid entity: \"%.8s\""), file, line, temp);
+      syntaxErrorCount += 1;
       ReleaseStack(temp);
       *ch = '&';
       return 1;
@@ -61,6 +61,8 @@ typedef enum {
    TOK_OUTLINE,
    TOK_PAGER,
    TOK_PAGERSTYLE,
+   TOK_PIXMAPCACHESIZE,
+   TOK_PLACEMENTMODE,
    TOK_POPUP,
    TOK_POPUPSTYLE,
    TOK_PROGRAM,
@@ -116,6 +118,9 @@ typedef struct TokenNode {
 
 } TokenNode;
 
+/** Number of syntax errors reported by Tokenize. */
+extern unsigned int syntaxErrorCount;
+
 /** Tokenize a buffer.
  * @param line The buffer to tokenize.
  * @param fileName The name of the file for error reporting.
@@ -16,11 +16,13 @@
 #include "event.h"
 
 #include "border.h"
+#include "cache.h"
 #include "client.h"
 #include "color.h"
 #include "command.h"
 #include "cursor.h"
 #include "confirm.h"
+#include "control.h"
 #include "font.h"
 #include "hint.h"
 #include "group.h"
@@ -41,6 +43,8 @@
 #include "dock.h"
 #include "misc.h"
 #include "background.h"
+#include "timing.h"
+#include "trace.h"
 
 Display *display = NULL;
 Window rootWindow;
@@ -80,6 +84,10 @@ XContext frameContext;
 int haveShape;
 int shapeEvent;
 #endif
+#ifdef USE_XSYNC
+int haveSync;
+int syncEvent;
+#endif
 #ifdef USE_XRENDER
 int haveRender;
 #endif
@@ -102,6 +110,7 @@ static void SendRestart();
 static void SendExit();
 static void SendReload();
 static void SendJWMMessage(const char *message);
+static void ShowReport(const char *name);
 
 static char *displayString = NULL;
 
@@ -146,6 +155,16 @@ int main(int argc, char *argv[]) {
 		} else if(!strcmp(argv[x], "-reload")) {
 			SendReload();
 			DoExit(0);
+      } else if(!strcmp(argv[x], "-stats")) {
+         ShowReport("_JWM_STATS");
+         DoExit(0);
+      } else if(!strcmp(argv[x], "-report")) {
+         ShowReport("_JWM_REPORT");
+         DoExit(0);
+      } else if(!strcmp(argv[x], "-timing")) {
+         showTiming = 1;
+      } else if(!strcmp(argv[x], "-trace") && x + 1 < argc) {
+         OpenTrace(argv[++x]);
       } else if(!strcmp(argv[x], "-display") && x + 1 < argc) {
          displayString = argv[++x];
       } else {
@@ -172,13 +191,16 @@ int main(int argc, char *argv[]) {
 		shouldReload = 0;
 
       /* Prepare JWM components. */
+      StartTimingPhase("initialize");
       Initialize();
 
       /* Parse the configuration file. */
+      StartTimingPhase("parse");
       ParseConfig(configPath);
 
       /* Start up the JWM components. */
       Startup();
+      StopTimingPhase();
 
       /* The main event loop. */
       EventLoop();
@@ -191,6 +213,7 @@ int main(int argc, char *argv[]) {
 
    } while(shouldRestart);
    ShutdownConnection();
+   CloseTrace();
 
    /* If we have a command to execute on shutdown, run it now. */
    if(exitCommand) {
@@ -210,6 +233,7 @@ int main(int argc, char *argv[]) {
 void DoExit(int code) {
 
    Destroy();
+   CloseTrace();
 
    if(configPath) {
       Release(configPath);
@@ -233,6 +257,11 @@ void EventLoop() {
    while(JLIKELY(!shouldExit)) {
       WaitForEvent(&event);
       ProcessEvent(&event);
+      if(shouldReload) {
+         /* Menus and move, resize, and pager loops have returned here. */
+         ReloadConfig(configPath);
+         shouldReload = 0;
+      }
    }
 
    /* Give windows (swallow windows especially) time to map. */
@@ -243,6 +272,7 @@ void EventLoop() {
       WaitForEvent(&event);
       ProcessEvent(&event);
    }
+   shouldReload = 0;
 
 }
 
@@ -281,6 +311,10 @@ void StartupConnection() {
 #ifdef USE_SHAPE
    int shapeError;
 #endif
+#ifdef USE_XSYNC
+   int syncError;
+   int syncMajor, syncMinor;
+#endif
 #ifdef USE_XRENDER
    int renderEvent;
    int renderError;
@@ -334,6 +368,16 @@ void StartupConnection() {
    }
 #endif
 
+#ifdef USE_XSYNC
+   haveSync = JXSyncQueryExtension(display, &syncEvent, &syncError)
+           && JXSyncInitialize(display, &syncMajor, &syncMinor);
+   if(haveSync) {
+      Debug("sync extension enabled");
+   } else {
+      Debug("sync extension disabled");
+   }
+#endif
+
 #ifdef USE_XRENDER
    haveRender = JXRenderQueryExtension(display, &renderEvent, &renderError);
    if(haveRender) {
@@ -356,6 +400,7 @@ void CloseConnection() {
 /** Close the X server connection. */
 void ShutdownConnection() {
    CloseConnection();
+   ForgetResources();
 }
 
 /** Signal handler. */
@@ -370,10 +415,12 @@ void Initialize() {
 
    InitializeBackgrounds();
    InitializeBorders();
+   InitializeCache();
    InitializeClients();
    InitializeClock();
    InitializeColors();
    InitializeCommands();
+   InitializeControl();
    InitializeCursors();
    InitializeDesktops();
 #ifndef DISABLE_CONFIRM
@@ -389,6 +436,7 @@ void Initialize() {
    InitializePager();
    InitializePlacement();
    InitializePopup();
+   InitializeResources();
    InitializeRootMenu();
    InitializeScreens();
    InitializeSwallow();
@@ -404,34 +452,46 @@ void Startup() {
 
    /* This order is important. */
 
+   StartTimingPhase("commands");
    StartupCommands();
 
    /* First we grab the server to prevent clients from changing things
     * while we're still loading. */
    JXGrabServer(display);
 
+   StartTimingPhase("screens");
    StartupScreens();
 
    StartupGroups();
+   StartTimingPhase("colors");
    StartupColors();
+   StartTimingPhase("icons");
+   StartupCache();
    StartupIcons();
    StartupBackgrounds();
+   StartTimingPhase("fonts");
    StartupFonts();
+   StartTimingPhase("cursors");
    StartupCursors();
    StartupOutline();
 
+   StartTimingPhase("tray");
    StartupPager();
    StartupClock();
    StartupTaskBar();
    StartupTrayButtons();
    StartupDock();
    StartupTray();
+   StartTimingPhase("keys");
    StartupKeys();
    StartupDesktops();
+   StartTimingPhase("hints");
    StartupHints();
    StartupBorders();
    StartupPlacement();
+   StartTimingPhase("clients");
    StartupClients();
+   PurgeIcons();
 
 #  ifndef DISABLE_CONFIRM
       StartupDialogs();
@@ -450,14 +510,19 @@ void Startup() {
    JXSync(display, True);
    JXUngrabServer(display);
 
+   StartTimingPhase("swallow");
    StartupSwallow();
 
    DrawTray();
 
+   StartupControl();
+   StartupResources();
+
    /* Send expose events. */
    ExposeCurrentDesktop();
 
    /* Draw the background (if backgrounds are used). */
+   StartTimingPhase("background");
    LoadBackground(currentDesktop);
 
 }
@@ -469,6 +534,8 @@ void Shutdown() {
 
    /* This order is important. */
 
+   ShutdownResources();
+   ShutdownControl();
    ShutdownSwallow();
 
    ShutdownOutline();
@@ -488,6 +555,7 @@ void Shutdown() {
    ShutdownClients();
    ShutdownBackgrounds();
    ShutdownIcons();
+   ShutdownCache();
    ShutdownCursors();
    ShutdownFonts();
    ShutdownColors();
@@ -509,10 +577,12 @@ void Shutdown() {
 void Destroy() {
    DestroyBackgrounds();
    DestroyBorders();
+   DestroyCache();
    DestroyClients();
    DestroyClock();
    DestroyColors();
    DestroyCommands();
+   DestroyControl();
    DestroyCursors();
    DestroyDesktops();
 #ifndef DISABLE_CONFIRM
@@ -528,6 +598,7 @@ void Destroy() {
    DestroyPager();
    DestroyPlacement();
    DestroyPopup();
+   DestroyResources();
    DestroyRootMenu();
    DestroyScreens();
    DestroySwallow();
@@ -570,3 +641,59 @@ void SendJWMMessage(const char *message) {
 
 }
 
+/** Ask the running JWM for a report and print it.
+ * The name is both the message sent and the property JWM writes.
+ */
+void ShowReport(const char *name) {
+
+   XEvent event;
+   Atom reportAtom;
+   Atom type;
+   int format;
+   unsigned long count, extra;
+   unsigned char *data;
+   int found;
+   int x;
+
+   OpenConnection();
+
+   reportAtom = JXInternAtom(display, name, False);
+   JXSelectInput(display, rootWindow, PropertyChangeMask);
+
+   memset(&event, 0, sizeof(event));
+   event.xclient.type = ClientMessage;
+   event.xclient.window = rootWindow;
+   event.xclient.message_type = reportAtom;
+   event.xclient.format = 32;
+   JXSendEvent(display, rootWindow, False, SubstructureRedirectMask, &event);
+   JXFlush(display);
+
+   /* Wait up to two seconds for the property to be written. */
+   found = 0;
+   for(x = 0; x < 200 && !found; x++) {
+      while(JXCheckTypedWindowEvent(display, rootWindow,
+                                    PropertyNotify, &event)) {
+         if(event.xproperty.atom == reportAtom) {
+            found = 1;
+         }
+      }
+      if(!found) {
+         usleep(10000);
+      }
+   }
+
+   if(found && JXGetWindowProperty(display, rootWindow, reportAtom, 0,
+                                   LONG_MAX / 4, False, XA_STRING, &type,
+                                   &format, &count, &extra,
+                                   &data) == Success) {
+      if(data) {
+         fputs((char*)data, stdout);
+         JXFree(data);
+      }
+   } else {
+      printf("error: no %s received from JWM\n", name);
+   }
+
+   CloseConnection();
+
+}
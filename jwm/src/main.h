@@ -54,6 +54,10 @@ extern XContext frameContext;
 extern int haveShape;
 extern int shapeEvent;
 #endif
+#ifdef USE_XSYNC
+extern int haveSync;
+extern int syncEvent;
+#endif
 #ifdef USE_XRENDER
 extern int haveRender;
 #endif
@@ -21,9 +21,23 @@
 #include "event.h"
 #include "error.h"
 #include "root.h"
+#include "misc.h"
+#include "cache.h"
 
 #define BASE_ICON_OFFSET 3
 
+/** Maximum length of the type-ahead search string. */
+#define MAX_SEARCH_LENGTH 32
+
+/** Milliseconds between key presses before a new search is started. */
+#define SEARCH_TIMEOUT 1000
+
+/** Lower-case item name used for type-ahead search. */
+typedef struct MenuSearchNode {
+   char *key;     /**< Lower-case item name. */
+   int index;     /**< Index of the item in the menu. */
+} MenuSearchNode;
+
 typedef enum {
    MENU_NOSELECTION = 0,
    MENU_LEAVE       = 1,
@@ -40,6 +54,8 @@ static int ShowSubmenu(Menu *menu, Menu *parent, int x, int y);
 static void CreateMenu(Menu *menu, int x, int y);
 static void HideMenu(Menu *menu);
 static void DrawMenu(Menu *menu);
+static void ScrollMenu(Menu *menu, int index);
+static void ReleaseMenuCache(void *object);
 static void RedrawMenuTree(Menu *menu);
 
 static int MenuLoop(Menu *menu);
@@ -51,23 +67,65 @@ static MenuItem *GetMenuItem(Menu *menu, int index);
 static int GetNextMenuIndex(Menu *menu);
 static int GetPreviousMenuIndex(Menu *menu);
 static int GetMenuIndex(Menu *menu, int index);
+static int GetItemBottom(const Menu *menu, int index);
 static void SetPosition(Menu *tp, int index);
 static int IsMenuValid(const Menu *menu);
 
+static void CreateSearchIndex(Menu *menu);
+static int CompareSearchNodes(const void *a, const void *b);
+static int SearchMenu(Menu *menu, XKeyEvent *event);
+static int FindSearchMatch(const Menu *menu, int start);
+
 static MenuAction *menuAction = NULL;
 static unsigned int menuOpacity = UINT_MAX;
 
+static char searchText[MAX_SEARCH_LENGTH + 1];
+static int searchLength = 0;
+static const Menu *searchMenu = NULL;
+static Time searchTime = CurrentTime;
+
 int menuShown = 0;
 
 /** Initialize a menu. */
 void InitializeMenu(Menu *menu) {
 
+   MenuItem *np;
+
+   menu->loaded = 0;
+   menu->pixmap = None;
+   menu->cache = NULL;
+   menu->offsets = NULL;
+   menu->table = NULL;
+   menu->search = NULL;
+   menu->searchCount = 0;
+   menu->parent = NULL;
+   menu->parentOffset = 0;
+   menu->firstIndex = 0;
+   menu->scroll = 0;
+
+   for(np = menu->items; np; np = np->next) {
+      np->icon = NULL;
+      if(np->submenu) {
+         InitializeMenu(np->submenu);
+      }
+   }
+
+}
+
+/** Load icons and compute the size of a menu. */
+void LayoutMenu(Menu *menu) {
+
    MenuItem *np;
    int index, temp;
    int userHeight;
    int hasSubmenu;
    char hasIcon;
 
+   if(menu->loaded) {
+      return;
+   }
+   menu->loaded = 1;
+
    menu->textOffset = 0;
    menu->itemCount = 0;
 
@@ -92,8 +150,6 @@ void InitializeMenu(Menu *menu) {
             }
             hasIcon = 1;
          }
-      } else {
-         np->icon = NULL;
       }
       menu->itemCount += 1;
    }
@@ -105,8 +161,6 @@ void InitializeMenu(Menu *menu) {
    }
 
    menu->width = 5;
-   menu->parent = NULL;
-   menu->parentOffset = 0;
 
    /* Make sure the menu is wide enough for a label if it is labeled. */
    if(menu->label) {
@@ -120,6 +174,7 @@ void InitializeMenu(Menu *menu) {
    if(menu->label) {
       menu->height += menu->itemHeight;
    }
+   menu->contentHeight = menu->height;
 
    /* Nothing else to do if there is nothing in the menu. */
    if(JUNLIKELY(menu->itemCount == 0)) {
@@ -127,10 +182,12 @@ void InitializeMenu(Menu *menu) {
    }
 
    menu->offsets = Allocate(sizeof(int) * menu->itemCount);
+   menu->table = Allocate(sizeof(MenuItem*) * menu->itemCount);
 
    hasSubmenu = 0;
    index = 0;
    for(np = menu->items; np; np = np->next) {
+      menu->table[index] = np;
       menu->offsets[index++] = menu->height;
       if(np->type == MENU_ITEM_SEPARATOR) {
          menu->height += 5;
@@ -148,12 +205,63 @@ void InitializeMenu(Menu *menu) {
       }
       if(np->submenu) {
          hasSubmenu = 7;
-         InitializeMenu(np->submenu);
       }
    }
    menu->height += 2;
    menu->width += 12 + hasSubmenu + menu->textOffset;
 
+   /* Menus taller than the screen are scrolled. */
+   menu->contentHeight = menu->height;
+   if(menu->height > rootHeight) {
+      menu->height = rootHeight;
+   }
+
+   CreateSearchIndex(menu);
+
+}
+
+/** Build the type-ahead search index for a menu. */
+void CreateSearchIndex(Menu *menu) {
+
+   MenuItem *np;
+   char *key;
+   int index;
+   int x;
+
+   menu->search = Allocate(sizeof(MenuSearchNode) * menu->itemCount);
+   menu->searchCount = 0;
+   index = 0;
+   for(np = menu->items; np; np = np->next) {
+      if(np->name && np->type != MENU_ITEM_SEPARATOR) {
+         key = CopyString(np->name);
+         for(x = 0; key[x]; x++) {
+            key[x] = tolower((unsigned char)key[x]);
+         }
+         menu->search[menu->searchCount].key = key;
+         menu->search[menu->searchCount].index = index;
+         menu->searchCount += 1;
+      }
+      index += 1;
+   }
+
+   qsort(menu->search, menu->searchCount, sizeof(MenuSearchNode),
+         CompareSearchNodes);
+
+}
+
+/** Compare search nodes by key and then by item index. */
+int CompareSearchNodes(const void *a, const void *b) {
+
+   const MenuSearchNode *na = (const MenuSearchNode*)a;
+   const MenuSearchNode *nb = (const MenuSearchNode*)b;
+   int result;
+
+   result = strcmp(na->key, nb->key);
+   if(result == 0) {
+      result = na->index - nb->index;
+   }
+   return result;
+
 }
 
 /** Show a menu. */
@@ -166,6 +274,8 @@ void ShowMenu(Menu *menu, RunMenuCommandType runner, int x, int y) {
       return;
    }
 
+   searchMenu = NULL;
+
    mouseStatus = GrabMouse(rootWindow);
    keyboardStatus = JXGrabKeyboard(display, rootWindow, False,
                                    GrabModeAsync, GrabModeAsync, CurrentTime);
@@ -184,17 +294,49 @@ void ShowMenu(Menu *menu, RunMenuCommandType runner, int x, int y) {
       menuAction = NULL;
    }
 
-   if(shouldReload) {
-      ReloadMenu();
+}
+
+/** Release the rendered contents of a menu and its submenus. */
+void ReleaseMenuPixmaps(Menu *menu) {
+
+   MenuItem *np;
+
+   if(menu->pixmap != None) {
+      RemoveCacheEntry(menu->cache);
+      menu->cache = NULL;
+      JXFreePixmap(display, menu->pixmap);
+      menu->pixmap = None;
+   }
+   for(np = menu->items; np; np = np->next) {
+      if(np->submenu) {
+         ReleaseMenuPixmaps(np->submenu);
+      }
    }
 
 }
 
+/** Release the rendered contents of a menu evicted from the cache.
+ * The menu is drawn again the next time it is shown.
+ */
+void ReleaseMenuCache(void *object) {
+
+   Menu *menu = (Menu*)object;
+
+   JXFreePixmap(display, menu->pixmap);
+   menu->pixmap = None;
+   menu->cache = NULL;
+
+}
+
 /** Destroy a menu. */
 void DestroyMenu(Menu *menu) {
    MenuItem *np;
 
    if(menu) {
+      if(menu->pixmap != None) {
+         RemoveCacheEntry(menu->cache);
+         JXFreePixmap(display, menu->pixmap);
+      }
       while(menu->items) {
          np = menu->items->next;
          if(menu->items->name) {
@@ -225,6 +367,16 @@ void DestroyMenu(Menu *menu) {
       if(menu->offsets) {
          Release(menu->offsets);
       }
+      if(menu->table) {
+         Release(menu->table);
+      }
+      if(menu->search) {
+         while(menu->searchCount > 0) {
+            menu->searchCount -= 1;
+            Release(menu->search[menu->searchCount].key);
+         }
+         Release(menu->search);
+      }
       Release(menu);
       menu = NULL;
    }
@@ -235,6 +387,7 @@ int ShowSubmenu(Menu *menu, Menu *parent, int x, int y) {
 
    int status;
 
+   LayoutMenu(menu);
    menu->parent = parent;
    CreateMenu(menu, x, y);
 
@@ -255,7 +408,6 @@ int MenuLoop(Menu *menu) {
 
    XEvent event;
    MenuItem *ip;
-   int count;
    int hadMotion;
    int pressx, pressy;
 
@@ -308,15 +460,9 @@ int MenuLoop(Menu *menu) {
             }
          }
             
-         if(menu->currentIndex >= 0) {
-            count = 0;
-            for(ip = menu->items; ip; ip = ip->next) {
-               if(count == menu->currentIndex) {
-                  menuAction = &ip->action;
-                  break;
-               }
-               ++count;
-            }
+         ip = GetMenuItem(menu, menu->currentIndex);
+         if(ip) {
+            menuAction = &ip->action;
          }
          return 1;
       default:
@@ -355,13 +501,37 @@ void CreateMenu(Menu *menu, int x, int y) {
    menu->y = y;
    menu->parentOffset = temp - y;
 
+   /* Render the visible rows once; the window uses them as its
+    * background so only the selection needs to be drawn after that.
+    * The pixmap stays in the cache until it is evicted, but it is
+    * locked while the menu is shown. */
+   if(menu->pixmap == None) {
+      menu->pixmap = JXCreatePixmap(display, rootWindow,
+                                    menu->width, menu->height, rootDepth);
+      menu->cache = AddCacheEntry(menu,
+         GetPixmapSize(menu->width, menu->height, rootDepth),
+         ReleaseMenuCache);
+      LockCacheEntry(menu->cache);
+      menu->firstIndex = 0;
+      menu->scroll = 0;
+      DrawMenu(menu);
+   } else {
+      TouchCacheEntry(menu->cache);
+      LockCacheEntry(menu->cache);
+      if(menu->firstIndex > 0) {
+         menu->firstIndex = 0;
+         menu->scroll = 0;
+         DrawMenu(menu);
+      }
+   }
+
    attrMask = 0;
 
    attrMask |= CWEventMask;
    attr.event_mask = ExposureMask;
 
-   attrMask |= CWBackPixel;
-   attr.background_pixel = colors[COLOR_MENU_BG];
+   attrMask |= CWBackPixmap;
+   attr.background_pixmap = menu->pixmap;
 
    attrMask |= CWSaveUnder;
    attr.save_under = True;
@@ -383,36 +553,42 @@ void CreateMenu(Menu *menu, int x, int y) {
 void HideMenu(Menu *menu) {
 
    JXDestroyWindow(display, menu->window);
+   UnlockCacheEntry(menu->cache);
 
 }
 
-/** Redraw a menu and its submenus. */
+/** Redraw the selection of a menu and its parents.
+ * The rest of the menu is restored from the window background.
+ */
 void RedrawMenuTree(Menu *menu) {
 
    if(menu->parent) {
       RedrawMenuTree(menu->parent);
    }
 
-   DrawMenu(menu);
    UpdateMenu(menu);
 
 }
 
-/** Draw a menu. */
+/** Render the visible rows of a menu to its pixmap. */
 void DrawMenu(Menu *menu) {
 
-   MenuItem *np;
    int x;
    XSegment segments[4];
 
+   JXSetForeground(display, rootGC, colors[COLOR_MENU_BG]);
+   JXFillRectangle(display, menu->pixmap, rootGC, 0, 0,
+                   menu->width, menu->height);
+
    if(menu->label) {
       DrawMenuItem(menu, NULL, -1);
    }
 
-   x = 0;
-   for(np = menu->items; np; np = np->next) {
-      DrawMenuItem(menu, np, x);
-      ++x;
+   for(x = menu->firstIndex; x < menu->itemCount; x++) {
+      if(menu->offsets[x] - menu->scroll >= menu->height - 2) {
+         break;
+      }
+      DrawMenuItem(menu, menu->table[x], x);
    }
 
    JXSetForeground(display, rootGC, colors[COLOR_MENU_UP]);
@@ -424,7 +600,7 @@ void DrawMenu(Menu *menu) {
    segments[2].x2 = 0;                 segments[2].y2 = menu->height - 1;
    segments[3].x1 = 1;                 segments[3].y1 = 2;
    segments[3].x2 = 1;                 segments[3].y2 = menu->height - 2;
-   JXDrawSegments(display, menu->window, rootGC, segments, 4);
+   JXDrawSegments(display, menu->pixmap, rootGC, segments, 4);
 
    JXSetForeground(display, rootGC, colors[COLOR_MENU_DOWN]);
    segments[0].x1 = 1;                 segments[0].y1 = menu->height - 1;
@@ -435,7 +611,23 @@ void DrawMenu(Menu *menu) {
    segments[2].x2 = menu->width - 1;   segments[2].y2 = menu->height - 3;
    segments[3].x1 = menu->width - 2;   segments[3].y1 = 2;
    segments[3].x2 = menu->width - 2;   segments[3].y2 = menu->height - 3;
-   JXDrawSegments(display, menu->window, rootGC, segments, 4);
+   JXDrawSegments(display, menu->pixmap, rootGC, segments, 4);
+
+}
+
+/** Scroll a shown menu so that the item at index is the first visible.
+ * Only the visible rows are drawn again.
+ */
+void ScrollMenu(Menu *menu, int index) {
+
+   menu->firstIndex = index;
+   menu->scroll = menu->offsets[index] - menu->offsets[0];
+   DrawMenu(menu);
+
+   /* The server may have copied the background; set it again. */
+   JXSetWindowBackgroundPixmap(display, menu->window, menu->pixmap);
+   JXClearWindow(display, menu->window);
+   menu->lastIndex = -1;
 
 }
 
@@ -510,17 +702,14 @@ MenuSelectionType UpdateMotion(Menu *menu, XEvent *event) {
       case KEY_ESC:
          return MENU_SUBSELECT;
       case KEY_ENTER:
-         if(tp->currentIndex >= 0) {
-            x = 0;
-            for(ip = tp->items; ip; ip = ip->next) {
-               if(x == tp->currentIndex) {
-                  menuAction = &ip->action;
-                  break;
-               }
-               ++x;
-            }
+         ip = GetMenuItem(tp, tp->currentIndex);
+         if(ip) {
+            menuAction = &ip->action;
          }
          return MENU_SUBSELECT;
+      case KEY_NONE:
+         y = SearchMenu(tp, &event->xkey);
+         break;
       default:
          break;
       }
@@ -536,6 +725,16 @@ MenuSelectionType UpdateMotion(Menu *menu, XEvent *event) {
       return MENU_SUBSELECT;
    }
 
+   /* Scroll if the pointer is at the top or bottom of a tall menu. */
+   if(menu->contentHeight > menu->height && x > 0 && x < menu->width) {
+      if(y <= 0 && menu->firstIndex > 0) {
+         ScrollMenu(menu, menu->firstIndex - 1);
+      } else if(y >= menu->height - 1
+         && menu->contentHeight - menu->scroll > menu->height) {
+         ScrollMenu(menu, menu->firstIndex + 1);
+      }
+   }
+
    /* Update the selection on the current menu */
    if(x > 0 && y > 0 && x < menu->width && y < menu->height) {
       menu->currentIndex = GetMenuIndex(menu, y);
@@ -564,27 +763,6 @@ MenuSelectionType UpdateMotion(Menu *menu, XEvent *event) {
 
    }
 
-   /* Move the menu if needed. */
-   if(menu->height > rootHeight && menu->currentIndex >= 0) {
-
-      /* If near the top, shift down. */
-      if(y + menu->y <= 0) {
-         if(menu->currentIndex > 0) {
-            --menu->currentIndex;
-            SetPosition(menu, menu->currentIndex);
-         }
-      }
-
-      /* If near the bottom, shift up. */
-      if(y + menu->y + menu->itemHeight / 2 >= rootHeight) {
-         if(menu->currentIndex + 1 < menu->itemCount) {
-            ++menu->currentIndex;
-            SetPosition(menu, menu->currentIndex);
-         }
-      }
-
-   }
-
    if(menu->lastIndex != menu->currentIndex) {
       UpdateMenu(menu);
       menu->lastIndex = menu->currentIndex;
@@ -594,7 +772,7 @@ MenuSelectionType UpdateMotion(Menu *menu, XEvent *event) {
    ip = GetMenuItem(menu, menu->currentIndex);
    if(ip && IsMenuValid(ip->submenu)) {
       if(ShowSubmenu(ip->submenu, menu, menu->x + menu->width,
-         menu->y + menu->offsets[menu->currentIndex])) {
+         menu->y + menu->offsets[menu->currentIndex] - menu->scroll)) {
 
          /* Item selected; destroy the menu tree. */
          return MENU_SUBSELECT;
@@ -617,10 +795,15 @@ void UpdateMenu(Menu *menu) {
    ButtonNode button;
    Pixmap pixmap;
    MenuItem *ip;
+   int y;
 
    /* Clear the old selection. */
    ip = GetMenuItem(menu, menu->lastIndex);
-   DrawMenuItem(menu, ip, menu->lastIndex);
+   if(ip && ip->type != MENU_ITEM_SEPARATOR) {
+      y = menu->offsets[menu->lastIndex] - menu->scroll;
+      JXClearArea(display, menu->window, 0, y,
+                  menu->width, menu->itemHeight, False);
+   }
 
    /* Highlight the new selection. */
    ip = GetMenuItem(menu, menu->currentIndex);
@@ -630,6 +813,11 @@ void UpdateMenu(Menu *menu) {
          return;
       }
 
+      y = menu->offsets[menu->currentIndex] - menu->scroll;
+      if(menu->currentIndex < menu->firstIndex || y >= menu->height - 2) {
+         return;
+      }
+
       ResetButton(&button, menu->window, rootGC);
       button.type = BUTTON_MENU_ACTIVE;
       button.font = FONT_MENU;
@@ -638,7 +826,7 @@ void UpdateMenu(Menu *menu) {
       button.icon = ip->icon;
       button.text = ip->name;
       button.x = 2;
-      button.y = menu->offsets[menu->currentIndex] + 1;
+      button.y = y + 1;
       DrawButton(&button);
 
       if(ip->submenu) {
@@ -647,12 +835,9 @@ void UpdateMenu(Menu *menu) {
          JXSetForeground(display, rootGC, colors[COLOR_MENU_ACTIVE_FG]);
          JXSetClipMask(display, rootGC, pixmap);
          JXSetClipOrigin(display, rootGC,
-            menu->width - 9,
-            menu->offsets[menu->currentIndex] + menu->itemHeight / 2 - 4);
+            menu->width - 9, y + menu->itemHeight / 2 - 4);
          JXFillRectangle(display, menu->window, rootGC,
-            menu->width - 9,
-            menu->offsets[menu->currentIndex] + menu->itemHeight / 2 - 4,
-            4, 7);
+            menu->width - 9, y + menu->itemHeight / 2 - 4, 4, 7);
          JXSetClipMask(display, rootGC, None);
          JXFreePixmap(display, pixmap);
       }
@@ -660,17 +845,18 @@ void UpdateMenu(Menu *menu) {
 
 }
 
-/** Draw a menu item. */
+/** Draw a menu item to the menu pixmap. */
 void DrawMenuItem(Menu *menu, MenuItem *item, int index) {
 
    ButtonNode button;
    Pixmap pixmap;
+   int y;
 
    Assert(menu);
 
    if(!item) {
       if(index == -1 && menu->label) {
-         ResetButton(&button, menu->window, rootGC);
+         ResetButton(&button, menu->pixmap, rootGC);
          button.x = 2;
          button.y = 2;
          button.width = menu->width - 5;
@@ -684,11 +870,12 @@ void DrawMenuItem(Menu *menu, MenuItem *item, int index) {
       return;
    }
 
+   y = menu->offsets[index] - menu->scroll;
    if(item->type != MENU_ITEM_SEPARATOR) {
 
-      ResetButton(&button, menu->window, rootGC);
+      ResetButton(&button, menu->pixmap, rootGC);
       button.x = 2;
-      button.y = 1 + menu->offsets[index];
+      button.y = 1 + y;
       button.font = FONT_MENU;
       button.type = BUTTON_LABEL;
       button.width = menu->width - 5;
@@ -700,23 +887,21 @@ void DrawMenuItem(Menu *menu, MenuItem *item, int index) {
    } else {
 
       JXSetForeground(display, rootGC, colors[COLOR_MENU_DOWN]);
-      JXDrawLine(display, menu->window, rootGC, 4,
-                 menu->offsets[index] + 2, menu->width - 6,
-                 menu->offsets[index] + 2);
+      JXDrawLine(display, menu->pixmap, rootGC, 4, y + 2,
+                 menu->width - 6, y + 2);
       JXSetForeground(display, rootGC, colors[COLOR_MENU_UP]);
-      JXDrawLine(display, menu->window, rootGC, 4,
-                 menu->offsets[index] + 3, menu->width - 6,
-                 menu->offsets[index] + 3);
+      JXDrawLine(display, menu->pixmap, rootGC, 4, y + 3,
+                 menu->width - 6, y + 3);
 
    }
 
    if(item->submenu) {
 
-      pixmap = JXCreatePixmapFromBitmapData(display, menu->window,
+      pixmap = JXCreatePixmapFromBitmapData(display, menu->pixmap,
          menu_bitmap, 4, 7, colors[COLOR_MENU_FG],
          colors[COLOR_MENU_BG], rootDepth);
-      JXCopyArea(display, pixmap, menu->window, rootGC, 0, 0, 4, 7,
-         menu->width - 9, menu->offsets[index] + menu->itemHeight / 2 - 4);
+      JXCopyArea(display, pixmap, menu->pixmap, rootGC, 0, 0, 4, 7,
+         menu->width - 9, y + menu->itemHeight / 2 - 4);
       JXFreePixmap(display, pixmap);
 
    }
@@ -757,69 +942,78 @@ int GetPreviousMenuIndex(Menu *menu) {
 
 }
 
-/** Get the item in the menu given a y-coordinate. */
+/** Get the item in the menu given a y-coordinate in the window. */
 int GetMenuIndex(Menu *menu, int y) {
 
-   int x;
+   int low, high, mid;
 
    if(y < menu->offsets[0]) {
       return -1;
    }
-   for(x = 0; x < menu->itemCount - 1; x++) {
-      if(y >= menu->offsets[x] && y < menu->offsets[x + 1]) {
-         return x;
+   y += menu->scroll;
+
+   /* Find the last item starting at or above y. */
+   low = 0;
+   high = menu->itemCount - 1;
+   while(low < high) {
+      mid = (low + high + 1) / 2;
+      if(menu->offsets[mid] <= y) {
+         low = mid;
+      } else {
+         high = mid - 1;
       }
    }
-   return x;
+   return low;
+
+}
+
+/** Get the y-offset of the bottom of a menu item. */
+int GetItemBottom(const Menu *menu, int index) {
+
+   if(index + 1 < menu->itemCount) {
+      return menu->offsets[index + 1];
+   } else {
+      return menu->contentHeight - 2;
+   }
 
 }
 
 /** Get the menu item associated with an index. */
 MenuItem *GetMenuItem(Menu *menu, int index) {
 
-   MenuItem *ip;
-
-   if(index >= 0) {
-      for(ip = menu->items; ip; ip = ip->next) {
-         if(!index) {
-            return ip;
-         }
-         --index;
-      }
+   if(index >= 0 && index < menu->itemCount) {
+      return menu->table[index];
    } else {
-      ip = NULL;
+      return NULL;
    }
 
-   return ip;
-
 }
 
 /** Set the active menu item. */
 void SetPosition(Menu *tp, int index) {
 
+   int first;
+   int bottom;
    int y;
-   int updated;
-
-   y = tp->offsets[index] + tp->itemHeight / 2;
-
-   if(tp->height > rootHeight) {
 
-      updated = 0;
-      while(y + tp->y < tp->itemHeight / 2) {
-         tp->y += tp->itemHeight;
-         updated = tp->itemHeight;
+   /* Scroll so that the item is visible. */
+   if(tp->contentHeight > tp->height) {
+      first = tp->firstIndex;
+      if(index < first) {
+         first = index;
       }
-      while(y + tp->y >= rootHeight) {
-         tp->y -= tp->itemHeight;
-         updated = -tp->itemHeight;
+      bottom = GetItemBottom(tp, index) + tp->offsets[0];
+      while(first < index
+         && bottom - tp->offsets[first] > tp->height - 2) {
+         first += 1;
       }
-      if(updated) {
-         JXMoveWindow(display, tp->window, tp->x, tp->y);
-         y += updated;
+      if(first != tp->firstIndex) {
+         ScrollMenu(tp, first);
       }
-
    }
 
+   y = tp->offsets[index] - tp->scroll + tp->itemHeight / 2;
+
    /* We need to do this twice so the event gets registered
     * on the submenu if one exists. */
    MoveMouse(tp->window, 6, y);
@@ -860,3 +1054,99 @@ void SetMenuOpacity(const char *str) {
 
 }
 
+/** Handle a key press that is not bound to a menu action.
+ * Printable characters are added to the search string and the index
+ * of the matching item is returned (or -1 if there is no match).
+ */
+int SearchMenu(Menu *menu, XKeyEvent *event) {
+
+   char buffer[8];
+   int count;
+   int start;
+
+   count = JXLookupString(event, buffer, sizeof(buffer), NULL, NULL);
+   if(count != 1 || !isprint((unsigned char)buffer[0])) {
+      return -1;
+   }
+
+   if(menu != searchMenu || event->time - searchTime > SEARCH_TIMEOUT) {
+      searchLength = 0;
+   }
+   searchMenu = menu;
+   searchTime = event->time;
+
+   if(searchLength < MAX_SEARCH_LENGTH) {
+      searchText[searchLength++] = tolower((unsigned char)buffer[0]);
+      searchText[searchLength] = 0;
+   }
+
+   /* Keep the current item while it still matches the longer string. */
+   if(searchLength > 1 && menu->currentIndex >= 0) {
+      start = menu->currentIndex;
+   } else {
+      start = menu->currentIndex + 1;
+   }
+
+   return FindSearchMatch(menu, start);
+
+}
+
+/** Find the first item at or after start that matches the search string.
+ * Prefix matches are preferred over substring matches.
+ */
+int FindSearchMatch(const Menu *menu, int start) {
+
+   const MenuSearchNode *np;
+   int low, high, mid;
+   int best, bestDistance;
+   int distance;
+   int x;
+
+   if(menu->searchCount == 0) {
+      return -1;
+   }
+
+   /* Binary search for the first key not less than the search string. */
+   low = 0;
+   high = menu->searchCount;
+   while(low < high) {
+      mid = (low + high) / 2;
+      if(strcmp(menu->search[mid].key, searchText) < 0) {
+         low = mid + 1;
+      } else {
+         high = mid;
+      }
+   }
+
+   best = -1;
+   bestDistance = menu->itemCount;
+   for(x = low; x < menu->searchCount; x++) {
+      np = &menu->search[x];
+      if(strncmp(np->key, searchText, searchLength)) {
+         break;
+      }
+      distance = (np->index - start + menu->itemCount) % menu->itemCount;
+      if(distance < bestDistance) {
+         best = np->index;
+         bestDistance = distance;
+      }
+   }
+   if(best >= 0) {
+      return best;
+   }
+
+   /* No prefix match; fall back to a substring match. */
+   for(x = 0; x < menu->searchCount; x++) {
+      np = &menu->search[x];
+      if(strstr(np->key, searchText)) {
+         distance = (np->index - start + menu->itemCount) % menu->itemCount;
+         if(distance < bestDistance) {
+            best = np->index;
+            bestDistance = distance;
+         }
+      }
+   }
+   return best;
+
+}
+
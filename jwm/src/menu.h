@@ -81,24 +81,39 @@ typedef struct Menu {
    int x;                  /**< The x-coordinate of the menu. */
    int y;                  /**< The y-coordinate of the menu. */
    int width;              /**< The width of the menu. */
-   int height;             /**< The height of the menu. */
+   int height;             /**< The height of the menu window. */
+   int contentHeight;      /**< The height of all menu items. */
+   int firstIndex;         /**< The first visible menu item. */
+   int scroll;             /**< y-offset of the first visible item. */
    int currentIndex;       /**< The current menu selection. */
    int lastIndex;          /**< The last menu selection. */
    unsigned int itemCount; /**< Number of menu items (excluding separators). */
    int parentOffset;       /**< y-offset of this menu wrt the parent. */
    int textOffset;         /**< x-offset of text in the menu. */
    int *offsets;           /**< y-offsets of menu items. */
+   struct MenuItem **table; /**< Menu items by index. */
+   struct MenuSearchNode *search; /**< Item names sorted for search. */
+   unsigned int searchCount; /**< Number of searchable items. */
    struct Menu *parent;    /**< The parent menu (or NULL). */
+   Pixmap pixmap;          /**< Rendered visible rows (or None). */
+   struct CacheEntry *cache; /**< Entry in the pixmap cache. */
+   char loaded;            /**< Set once icons and layout are ready. */
 
 } Menu;
 
 typedef void (*RunMenuCommandType)(const MenuAction *action);
 
 /** Initialize a menu structure to be shown.
+ * Icons are not loaded until the menu is first shown.
  * @param menu The menu to initialize.
  */
 void InitializeMenu(Menu *menu);
 
+/** Load icons and compute the size of a menu if not already done.
+ * @param menu The menu to lay out.
+ */
+void LayoutMenu(Menu *menu);
+
 /** Show a menu.
  * @param menu The menu to show.
  * @param runner Callback executed when an item is selected.
@@ -107,6 +122,11 @@ void InitializeMenu(Menu *menu);
  */
 void ShowMenu(Menu *menu, RunMenuCommandType runner, int x, int y);
 
+/** Release the rendered contents of a menu and its submenus.
+ * @param menu The menu.
+ */
+void ReleaseMenuPixmaps(Menu *menu);
+
 /** Destroy a menu structure.
  * @param menu The menu to destroy.
  */
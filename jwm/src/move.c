@@ -24,6 +24,10 @@
 #include "status.h"
 #include "tray.h"
 #include "desktop.h"
+#include "timing.h"
+
+/** Default number of configure events per second during a move. */
+#define DEFAULT_MOVE_RATE 60
 
 typedef struct {
    int valid;
@@ -36,6 +40,7 @@ static SnapModeType snapMode = SNAP_BORDER;
 static int snapDistance = DEFAULT_SNAP_DISTANCE;
 
 static MoveModeType moveMode = MOVE_OPAQUE;
+static unsigned int moveDelay = 1000 / DEFAULT_MOVE_RATE;
 
 static void StopMove(ClientNode *np,
    int doMove, int oldx, int oldy, int hmax, int vmax);
@@ -71,6 +76,28 @@ void SetMoveMode(MoveModeType mode) {
    moveMode = mode;
 }
 
+/** Set the maximum number of configure events per second. */
+void SetMoveRate(const char *value) {
+
+   int temp;
+
+   if(!value) {
+      moveDelay = 1000 / DEFAULT_MOVE_RATE;
+      return;
+   }
+
+   temp = atoi(value);
+   if(JUNLIKELY(temp < 0)) {
+      Warning(_("invalid move rate specified: %d"), temp);
+      moveDelay = 1000 / DEFAULT_MOVE_RATE;
+   } else if(temp == 0) {
+      moveDelay = 0;
+   } else {
+      moveDelay = 1000 / temp;
+   }
+
+}
+
 /** Set the snap distance. */
 void SetSnapDistance(const char *value) {
    int temp;
@@ -111,6 +138,8 @@ void MoveController(int wasDestroyed) {
 int MoveClient(ClientNode *np, int startx, int starty, int snap) {
 
    XEvent event;
+   TimeType now;
+   TimeType lastConfigure = ZERO_TIME;
    int oldx, oldy;
    int doMove;
    int north, south, east, west;
@@ -234,7 +263,6 @@ int MoveClient(ClientNode *np, int startx, int starty, int snap) {
          if(doMove) {
 
             if(moveMode == MOVE_OUTLINE) {
-               ClearOutline();
                height = north + south;
                if(!(np->state.status & STAT_SHADED)) {
                   height += np->height;
@@ -244,7 +272,15 @@ int MoveClient(ClientNode *np, int startx, int starty, int snap) {
             } else {
                JXMoveWindow(display, np->parent, np->x - west,
                   np->y - north);
-               SendConfigureEvent(np);
+
+               /* The frame follows the pointer, but the client is only
+                * told about its position once per frame. StopMove sends
+                * the final position. */
+               GetCurrentTime(&now);
+               if(GetTimeDifference(&now, &lastConfigure) >= moveDelay) {
+                  SendConfigureEvent(np);
+                  lastConfigure = now;
+               }
             }
             UpdateMoveWindow(np);
             UpdatePager();
@@ -382,7 +418,6 @@ int MoveClientKeyboard(ClientNode *np) {
       if(moved) {
 
          if(moveMode == MOVE_OUTLINE) {
-            ClearOutline();
             DrawOutline(np->x - west, np->y - west,
                np->width + west + east, height + north + west);
          } else {
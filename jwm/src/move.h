@@ -58,5 +58,11 @@ void SetDefaultSnapDistance();
  */
 void SetMoveMode(MoveModeType mode);
 
+/** Set the maximum number of configure events per second sent to a
+ * client during an opaque move.
+ * @param value The rate (0 for no limit, NULL for the default).
+ */
+void SetMoveRate(const char *value);
+
 #endif /* MOVE_H */
 
@@ -10,10 +10,25 @@
 #include "jwm.h"
 #include "outline.h"
 #include "main.h"
+#include "color.h"
+#include "misc.h"
 
-static GC outlineGC;
-static int lastX, lastY;
-static int lastWidth, lastHeight;
+/** Width of the outline in pixels. */
+#define OUTLINE_WIDTH 2
+
+/** Sides of the outline. */
+typedef enum {
+   OUTLINE_TOP,
+   OUTLINE_BOTTOM,
+   OUTLINE_LEFT,
+   OUTLINE_RIGHT,
+   OUTLINE_COUNT
+} OutlineSideType;
+
+/* The outline is drawn with a thin window for each side rather than
+ * by inverting the root window, so the server does not need to be
+ * grabbed and other programs keep drawing while a window is moved. */
+static Window outlineWindows[OUTLINE_COUNT];
 static char outlineDrawn;
 
 /** Initialize outline data. */
@@ -23,48 +38,79 @@ void InitializeOutline() {
 /** Startup outlines. */
 void StartupOutline() {
 
-   XGCValues gcValues;
+   XSetWindowAttributes attr;
+   unsigned long attrMask;
+   int x;
+
+   attrMask = CWOverrideRedirect | CWSaveUnder | CWBackPixel;
+   attr.override_redirect = True;
+   attr.save_under = True;
+   attr.background_pixel = colors[COLOR_TITLE_ACTIVE_BG1];
 
-   gcValues.function = GXinvert;
-   gcValues.subwindow_mode = IncludeInferiors;
-   gcValues.line_width = 2;
-   outlineGC = JXCreateGC(display, rootWindow,
-      GCFunction | GCSubwindowMode | GCLineWidth, &gcValues);
+   for(x = 0; x < OUTLINE_COUNT; x++) {
+      outlineWindows[x] = JXCreateWindow(display, rootWindow, 0, 0, 1, 1,
+         0, CopyFromParent, InputOutput, CopyFromParent, attrMask, &attr);
+   }
    outlineDrawn = 0;
 
 }
 
 /** Shutdown outlines. */
 void ShutdownOutline() {
-   JXFreeGC(display, outlineGC);
+
+   int x;
+
+   for(x = 0; x < OUTLINE_COUNT; x++) {
+      JXDestroyWindow(display, outlineWindows[x]);
+   }
+
 }
 
 /** Release outline data. */
 void DestroyOutline() {
 }
 
-/** Draw an outline. */
+/** Draw an outline.
+ * The windows are mapped the first time the outline is drawn during a
+ * move or resize; after that they are only moved and resized.
+ */
 void DrawOutline(int x, int y, int width, int height) {
+
+   int side;
+
+   width = Max(width, 2 * OUTLINE_WIDTH);
+   height = Max(height, 2 * OUTLINE_WIDTH);
+
+   JXMoveResizeWindow(display, outlineWindows[OUTLINE_TOP],
+      x, y, width, OUTLINE_WIDTH);
+   JXMoveResizeWindow(display, outlineWindows[OUTLINE_BOTTOM],
+      x, y + height - OUTLINE_WIDTH, width, OUTLINE_WIDTH);
+   JXMoveResizeWindow(display, outlineWindows[OUTLINE_LEFT],
+      x, y + OUTLINE_WIDTH, OUTLINE_WIDTH, height - 2 * OUTLINE_WIDTH);
+   JXMoveResizeWindow(display, outlineWindows[OUTLINE_RIGHT],
+      x + width - OUTLINE_WIDTH, y + OUTLINE_WIDTH,
+      OUTLINE_WIDTH, height - 2 * OUTLINE_WIDTH);
+
    if(!outlineDrawn) {
-      JXSync(display, False);
-      JXGrabServer(display);
-      JXDrawRectangle(display, rootWindow, outlineGC, x, y, width, height);
-      lastX = x;
-      lastY = y;
-      lastWidth = width;
-      lastHeight = height;
+      for(side = 0; side < OUTLINE_COUNT; side++) {
+         JXMapRaised(display, outlineWindows[side]);
+      }
       outlineDrawn = 1;
    }
+
 }
 
-/** Clear the last outline. */
+/** Clear the outline when a move or resize stops. */
 void ClearOutline() {
+
+   int side;
+
    if(outlineDrawn) {
-      JXDrawRectangle(display, rootWindow, outlineGC,
-                      lastX, lastY, lastWidth, lastHeight);
+      for(side = 0; side < OUTLINE_COUNT; side++) {
+         JXUnmapWindow(display, outlineWindows[side]);
+      }
       outlineDrawn = 0;
-      JXUngrabServer(display);
-      JXSync(display, False);
    }
+
 }
 
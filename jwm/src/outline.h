@@ -17,7 +17,7 @@ void ShutdownOutline();
 void DestroyOutline();
 /*@}*/
 
-/** Draw an outline.
+/** Draw an outline or move the outline already shown.
  * @param x The x-coordinate.
  * @param y The y-coordinate.
  * @param width The width of the outline.
@@ -25,7 +25,7 @@ void DestroyOutline();
  */
 void DrawOutline(int x, int y, int width, int height);
 
-/** Clear an outline. */
+/** Clear the outline (at the end of a move or resize). */
 void ClearOutline();
 
 #endif /* OUTLINE_H */
@@ -21,6 +21,7 @@
 #include "timing.h"
 #include "popup.h"
 #include "font.h"
+#include "stats.h"
 
 /** Structure to represent a pager tray component. */
 typedef struct PagerType {
@@ -501,11 +502,13 @@ void UpdatePager() {
    int xc, yc;
    int textWidth, textHeight;
    int dx, dy;
+   ProfileTime start;
 
    if(JUNLIKELY(shouldExit)) {
       return;
    }
 
+   start = StartProfile();
    for(pp = pagers; pp; pp = pp->next) {
 
       buffer = pp->cp->pixmap;
@@ -569,6 +572,7 @@ void UpdatePager() {
       UpdateSpecificTray(pp->cp->tray, pp->cp);
 
    }
+   StopProfile(PROFILE_UPDATE_PAGER, start);
 
 }
 
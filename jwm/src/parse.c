@@ -39,6 +39,12 @@
 #include "status.h"
 #include "background.h"
 #include "spacer.h"
+#include "stats.h"
+#include "cache.h"
+#include "place.h"
+#include "outline.h"
+#include "border.h"
+#include "hint.h"
 
 /** Structure to map key names to key types. */
 typedef struct KeyMapType {
@@ -129,15 +135,49 @@ static const char *DELAY_ATTRIBUTE = "delay";
 static const char *ENABLED_ATTRIBUTE = "enabled";
 static const char *COORDINATES_ATTRIBUTE = "coordinates";
 static const char *TYPE_ATTRIBUTE = "type";
+static const char *AFTER_ATTRIBUTE = "after";
+static const char *RATE_ATTRIBUTE = "rate";
 
 static const char *FALSE_VALUE = "false";
 static const char *TRUE_VALUE = "true";
 
+/** Parts of the configuration that can be reloaded separately. */
+typedef enum {
+   SECTION_MENU,        /**< Root menus. */
+   SECTION_KEYS,        /**< Key bindings. */
+   SECTION_STYLES,      /**< Window, menu, popup, and tray styles. */
+   SECTION_TRAY,        /**< Trays. */
+   SECTION_BACKGROUNDS, /**< Desktop backgrounds. */
+   SECTION_COMMANDS,    /**< Restart and shutdown commands. */
+   SECTION_STARTUP,     /**< Startup commands (only used at startup). */
+   SECTION_OTHER,       /**< Everything else (requires a restart). */
+   SECTION_COUNT
+} ConfigSectionType;
+
+#define ALL_SECTIONS ((1 << SECTION_COUNT) - 1)
+#define PARSING(s) (parseSections & (1 << (s)))
+
+/* Hash of the tags in each section from the last parse and the sections
+ * that are applied while parsing (the rest are only hashed). */
+static unsigned long sectionHashes[SECTION_COUNT];
+static unsigned int parseSections = ALL_SECTIONS;
+
+/** Number of errors reported by ParseError. */
+static unsigned int parseErrorCount = 0;
+
 static int ParseFile(const char *fileName, int depth);
 static char *ReadFile(FILE *fd);
 
 /* Misc. */
 static void Parse(const TokenNode *start, int depth);
+static int ParseSections(const char *fileName, unsigned int sections);
+static void ResetSections(unsigned int sections);
+static void StartupSections(unsigned int sections);
+static ConfigSectionType GetConfigSection(TokenType type);
+static unsigned long HashNode(unsigned long hash, const TokenNode *tp);
+static unsigned long HashToken(unsigned long hash, const TokenNode *tp);
+static unsigned long HashDesktops(unsigned long hash, const TokenNode *tp);
+static unsigned long HashString(unsigned long hash, const char *str);
 static void ParseInclude(const TokenNode *tp, int depth);
 static void ParseDesktops(const TokenNode *tp);
 static void ParseDesktop(int desktop, const TokenNode *tp);
@@ -184,6 +224,7 @@ static void ParseSnapMode(const TokenNode *tp);
 static void ParseMoveMode(const TokenNode *tp);
 static void ParseResizeMode(const TokenNode *tp);
 static void ParseFocusModel(const TokenNode *tp);
+static void ParsePlacementMode(const TokenNode *tp);
 
 static void ParseGradient(const char *value, ColorType a, ColorType b);
 static char *FindAttribute(AttributeNode *ap, const char *name);
@@ -193,13 +234,339 @@ static void ParseError(const TokenNode *tp, const char *str, ...);
 
 /** Parse the JWM configuration. */
 void ParseConfig(const char *fileName) {
-   if(!ParseFile(fileName, 0)) {
-      if(JUNLIKELY(!ParseFile(SYSTEM_CONFIG, 0))) {
+   ProfileTime start = StartProfile();
+   if(!ParseSections(fileName, ALL_SECTIONS)) {
+      if(JUNLIKELY(!ParseSections(SYSTEM_CONFIG, ALL_SECTIONS))) {
          ParseError(NULL, "could not open %s or %s", fileName, SYSTEM_CONFIG);
       }
    }
    ValidateTrayButtons();
    ValidateKeys();
+   StopProfile(PROFILE_PARSE_CONFIG, start);
+}
+
+/** Reload the JWM configuration.
+ * The file is hashed first and only the sections that changed are
+ * applied. Nothing is applied if the file has errors. The parts of JWM
+ * that use a changed section are shut down and started again; settings
+ * that are only read at startup need a restart, which is left to the user.
+ */
+void ReloadConfig(const char *fileName) {
+
+   unsigned long oldHashes[SECTION_COUNT];
+   unsigned int errorCount;
+   unsigned int changed;
+   const char *path;
+   int opened;
+   int x;
+
+   /* Hash the new configuration without applying anything. */
+   memcpy(oldHashes, sectionHashes, sizeof(oldHashes));
+   errorCount = syntaxErrorCount + parseErrorCount;
+   path = fileName;
+   opened = ParseSections(path, 0);
+   if(!opened) {
+      path = SYSTEM_CONFIG;
+      opened = ParseSections(path, 0);
+   }
+   if(JUNLIKELY(!opened
+      || syntaxErrorCount + parseErrorCount != errorCount)) {
+      memcpy(sectionHashes, oldHashes, sizeof(oldHashes));
+      Warning(_("configuration not reloaded: %s"), fileName);
+      return;
+   }
+
+   changed = 0;
+   for(x = 0; x < SECTION_COUNT; x++) {
+      if(sectionHashes[x] != oldHashes[x]) {
+         changed |= 1 << x;
+      }
+   }
+   if(changed & (1 << SECTION_OTHER)) {
+      /* Keep the old hash so this is reported until JWM restarts. */
+      Warning(_("restart JWM to apply all configuration changes"));
+      sectionHashes[SECTION_OTHER] = oldHashes[SECTION_OTHER];
+   }
+
+   /* Startup commands are only used at startup. */
+   changed &= ~((1 << SECTION_OTHER) | (1 << SECTION_STARTUP));
+   if(changed == 0) {
+      return;
+   }
+
+   /* The trays are created from the tray styles and the menus are laid
+    * out with the menu style, so these are rebuilt together. */
+   if(changed & ((1 << SECTION_STYLES) | (1 << SECTION_TRAY))) {
+      changed |= (1 << SECTION_STYLES) | (1 << SECTION_TRAY)
+               | (1 << SECTION_MENU);
+   }
+
+   ResetSections(changed);
+   ParseSections(path, changed);
+   sectionHashes[SECTION_OTHER] = oldHashes[SECTION_OTHER];
+   ValidateTrayButtons();
+   ValidateKeys();
+   StartupSections(changed);
+
+}
+
+/** Parse the configuration applying only some sections.
+ * All sections are hashed.
+ * @return 1 if the file was parsed, 0 if it could not be opened.
+ */
+int ParseSections(const char *fileName, unsigned int sections) {
+
+   int result;
+
+   memset(sectionHashes, 0, sizeof(sectionHashes));
+   parseSections = sections;
+   result = ParseFile(fileName, 0);
+   parseSections = ALL_SECTIONS;
+
+   return result;
+
+}
+
+/** Shut down and initialize the parts of JWM using some sections.
+ * This follows the order used by main.c.
+ */
+void ResetSections(unsigned int sections) {
+
+   const char styles = (sections & (1 << SECTION_STYLES)) != 0;
+   const char menus = (sections & (1 << SECTION_MENU)) != 0;
+   const char keys = (sections & (1 << SECTION_KEYS)) != 0;
+   const char backgrounds = (sections & (1 << SECTION_BACKGROUNDS)) != 0;
+
+   if(styles) {
+      ShutdownSwallow();
+      ShutdownOutline();
+      ShutdownPopup();
+   }
+   if(keys) {
+      ShutdownKeys();
+   }
+   if(styles) {
+      ShutdownPager();
+   }
+   if(menus) {
+      ShutdownRootMenu();
+   }
+   if(styles) {
+      ShutdownDock();
+      ShutdownTray();
+      ShutdownTrayButtons();
+      ShutdownTaskBar();
+      ShutdownClock();
+   }
+   if(backgrounds) {
+      ShutdownBackgrounds();
+   }
+   if(styles) {
+      ShutdownFonts();
+      ShutdownColors();
+   }
+
+   if(styles) {
+      DestroySwallow();
+      DestroyOutline();
+      DestroyPopup();
+   }
+   if(keys) {
+      DestroyKeys();
+   }
+   if(styles) {
+      DestroyPager();
+   }
+   if(menus) {
+      DestroyRootMenu();
+   }
+   if(styles) {
+      DestroyDock();
+      DestroyTray();
+      DestroyTrayButtons();
+      DestroyTaskBar();
+      DestroyClock();
+   }
+   if(backgrounds) {
+      DestroyBackgrounds();
+   }
+   if(styles) {
+      DestroyFonts();
+      DestroyColors();
+   }
+   if(sections & (1 << SECTION_COMMANDS)) {
+      ReleaseExitCommands();
+   }
+
+   if(backgrounds) {
+      InitializeBackgrounds();
+   }
+   if(styles) {
+      InitializeClock();
+      InitializeColors();
+      InitializeDock();
+      InitializeFonts();
+   }
+   if(keys) {
+      InitializeKeys();
+   }
+   if(styles) {
+      InitializeOutline();
+      InitializePager();
+      InitializePopup();
+   }
+   if(menus) {
+      InitializeRootMenu();
+   }
+   if(styles) {
+      InitializeSwallow();
+      InitializeTaskBar();
+      InitializeTray();
+      InitializeTrayButtons();
+   }
+
+}
+
+/** Start the parts of JWM reset by ResetSections. */
+void StartupSections(unsigned int sections) {
+
+   const char styles = (sections & (1 << SECTION_STYLES)) != 0;
+   const char menus = (sections & (1 << SECTION_MENU)) != 0;
+   const char keys = (sections & (1 << SECTION_KEYS)) != 0;
+   const char backgrounds = (sections & (1 << SECTION_BACKGROUNDS)) != 0;
+
+   if(styles) {
+      StartupColors();
+   }
+   if(backgrounds) {
+      StartupBackgrounds();
+   }
+   if(styles) {
+      StartupFonts();
+      StartupOutline();
+      StartupPager();
+      StartupClock();
+      StartupTaskBar();
+      StartupTrayButtons();
+      StartupDock();
+      StartupTray();
+      WriteSupportingWindow();
+   }
+   if(keys) {
+      StartupKeys();
+   }
+   if(styles) {
+      StartupPopup();
+   }
+   if(menus) {
+      StartupRootMenu();
+   }
+   if(styles) {
+      RestackClients();
+      StartupSwallow();
+      DrawTray();
+      UpdateBorders();
+   }
+   if(backgrounds) {
+      LoadBackground(currentDesktop);
+   }
+
+}
+
+/** Get the section of the configuration a top-level tag belongs to. */
+ConfigSectionType GetConfigSection(TokenType type) {
+   switch(type) {
+   case TOK_ROOTMENU:
+      return SECTION_MENU;
+   case TOK_KEY:
+      return SECTION_KEYS;
+   case TOK_WINDOWSTYLE:
+   case TOK_MENUSTYLE:
+   case TOK_POPUPSTYLE:
+   case TOK_TRAYSTYLE:
+   case TOK_TASKLISTSTYLE:
+   case TOK_PAGERSTYLE:
+   case TOK_CLOCKSTYLE:
+   case TOK_TRAYBUTTONSTYLE:
+      return SECTION_STYLES;
+   case TOK_TRAY:
+      return SECTION_TRAY;
+   case TOK_RESTARTCOMMAND:
+   case TOK_SHUTDOWNCOMMAND:
+      return SECTION_COMMANDS;
+   case TOK_STARTUPCOMMAND:
+      return SECTION_STARTUP;
+   default:
+      return SECTION_OTHER;
+   }
+}
+
+/** Add a tag and its attributes (but not its children) to a hash. */
+unsigned long HashNode(unsigned long hash, const TokenNode *tp) {
+
+   const AttributeNode *ap;
+
+   hash = (hash ^ tp->type) * 16777619UL;
+   hash = HashString(hash, tp->value);
+   for(ap = tp->attributes; ap; ap = ap->next) {
+      hash = HashString(hash, ap->name);
+      hash = HashString(hash, ap->value);
+   }
+
+   return hash;
+
+}
+
+/** Add a tag, its attributes, and its children to a hash. */
+unsigned long HashToken(unsigned long hash, const TokenNode *tp) {
+
+   const TokenNode *np;
+
+   hash = HashNode(hash, tp);
+   for(np = tp->subnodeHead; np; np = np->next) {
+      hash = HashToken(hash, np);
+   }
+
+   /* Mark the end of the children so nesting changes the hash. */
+   return (hash ^ 0xFF) * 16777619UL;
+
+}
+
+/** Add a Desktops tag without its backgrounds to a hash. */
+unsigned long HashDesktops(unsigned long hash, const TokenNode *tp) {
+
+   const TokenNode *np;
+   const TokenNode *bp;
+
+   hash = HashNode(hash, tp);
+   for(np = tp->subnodeHead; np; np = np->next) {
+      if(np->type == TOK_DESKTOP) {
+         hash = HashNode(hash, np);
+         for(bp = np->subnodeHead; bp; bp = bp->next) {
+            if(bp->type != TOK_BACKGROUND) {
+               hash = HashToken(hash, bp);
+            }
+         }
+         hash = (hash ^ 0xFF) * 16777619UL;
+      } else if(np->type != TOK_BACKGROUND) {
+         hash = HashToken(hash, np);
+      }
+   }
+
+   return (hash ^ 0xFF) * 16777619UL;
+
+}
+
+/** Add a string to a hash (NULL and empty strings differ). */
+unsigned long HashString(unsigned long hash, const char *str) {
+   if(str) {
+      while(*str) {
+         hash = (hash ^ (unsigned char)*str) * 16777619UL;
+         str += 1;
+      }
+      hash = (hash ^ 0x100) * 16777619UL;
+   }
+   return (hash ^ 0x200) * 16777619UL;
 }
 
 /**
@@ -282,6 +649,8 @@ void ReleaseTokens(TokenNode *np) {
 void Parse(const TokenNode *start, int depth) {
 
    TokenNode *tp;
+   ConfigSectionType section;
+   unsigned int sections;
 
    if(!start) {
       return;
@@ -289,107 +658,121 @@ void Parse(const TokenNode *start, int depth) {
 
    if(JLIKELY(start->type == TOK_JWM)) {
       for(tp = start->subnodeHead; tp; tp = tp->next) {
-         if(shouldReload) {
-            switch(tp->type) {
-            case TOK_ROOTMENU:
-               ParseRootMenu(tp);
-               break;
-            case TOK_INCLUDE:
-               ParseInclude(tp, depth);
-               break;
-            default:
-               break;
-            }
+         if(tp->type == TOK_INCLUDE) {
+            ParseInclude(tp, depth);
+            continue;
+         }
+         if(JUNLIKELY(tp->type == TOK_INVALID)) {
+            InvalidTag(tp, TOK_JWM);
+            continue;
+         }
+         if(tp->type == TOK_DESKTOPS) {
+            /* Backgrounds are reloaded without the other desktop settings. */
+            sectionHashes[SECTION_BACKGROUNDS]
+               = HashToken(sectionHashes[SECTION_BACKGROUNDS], tp);
+            sectionHashes[SECTION_OTHER]
+               = HashDesktops(sectionHashes[SECTION_OTHER], tp);
+            sections = (1 << SECTION_BACKGROUNDS) | (1 << SECTION_OTHER);
          } else {
-            switch(tp->type) {
-            case TOK_DESKTOPS:
-               ParseDesktops(tp);
-               break;
-            case TOK_DOUBLECLICKSPEED:
-               SetDoubleClickSpeed(tp->value);
-               break;
-            case TOK_DOUBLECLICKDELTA:
-               SetDoubleClickDelta(tp->value);
-               break;
-            case TOK_FOCUSMODEL:
-               ParseFocusModel(tp);
-               break;
-            case TOK_GROUP:
-               ParseGroup(tp);
-               break;
-            case TOK_ICONPATH:
-               AddIconPath(tp->value);
-               break;
-            case TOK_INCLUDE:
-               ParseInclude(tp, depth);
-               break;
-            case TOK_KEY:
-               ParseKey(tp);
-               break;
-            case TOK_MENUSTYLE:
-               ParseMenuStyle(tp);
-               break;
-            case TOK_MOVEMODE:
-               ParseMoveMode(tp);
-               break;
-            case TOK_PAGERSTYLE:
-               ParsePagerStyle(tp);
-               break;
-            case TOK_POPUPSTYLE:
-               ParsePopupStyle(tp);
-               break;
-            case TOK_RESIZEMODE:
-               ParseResizeMode(tp);
-               break;
-            case TOK_RESTARTCOMMAND:
-               AddRestartCommand(tp->value);
-               break;
-            case TOK_ROOTMENU:
-               ParseRootMenu(tp);
-               break;
-            case TOK_SHUTDOWNCOMMAND:
-               AddShutdownCommand(tp->value);
-               break;
-            case TOK_SNAPMODE:
-               ParseSnapMode(tp);
-               break;
-            case TOK_STARTUPCOMMAND:
-               AddStartupCommand(tp->value);
-               break;
-            case TOK_TASKLISTSTYLE:
-               ParseTaskListStyle(tp);
-               break;
-            case TOK_TRAY:
-               ParseTray(tp);
-               break;
-            case TOK_TRAYSTYLE:
-               ParseTrayStyle(tp);
-               break;
-            case TOK_TRAYBUTTONSTYLE:
-               ParseTrayButtonStyle(tp);
-               break;
-            case TOK_CLOCKSTYLE:
-               ParseClockStyle(tp);
-               break;
-            case TOK_WINDOWSTYLE:
-               ParseWindowStyle(tp);
-               break;
-            case TOK_BUTTONCLOSE:
-               SetButtonMask(BP_CLOSE, tp->value);
-               break;
-            case TOK_BUTTONMIN:
-               SetButtonMask(BP_MINIMIZE, tp->value);
-               break;
-            case TOK_BUTTONMAX:
-               SetButtonMask(BP_MAXIMIZE, tp->value);
-               break;
-            case TOK_BUTTONMAXACTIVE:
-               SetButtonMask(BP_MAXIMIZE_ACTIVE, tp->value);
-               break;
-            default:
-               InvalidTag(tp, TOK_JWM);
-               break;
-            }
+            section = GetConfigSection(tp->type);
+            sectionHashes[section] = HashToken(sectionHashes[section], tp);
+            sections = 1 << section;
+         }
+         if(!(parseSections & sections)) {
+            continue;
+         }
+         switch(tp->type) {
+         case TOK_DESKTOPS:
+            ParseDesktops(tp);
+            break;
+         case TOK_DOUBLECLICKSPEED:
+            SetDoubleClickSpeed(tp->value);
+            break;
+         case TOK_DOUBLECLICKDELTA:
+            SetDoubleClickDelta(tp->value);
+            break;
+         case TOK_FOCUSMODEL:
+            ParseFocusModel(tp);
+            break;
+         case TOK_GROUP:
+            ParseGroup(tp);
+            break;
+         case TOK_ICONPATH:
+            AddIconPath(tp->value);
+            break;
+         case TOK_KEY:
+            ParseKey(tp);
+            break;
+         case TOK_MENUSTYLE:
+            ParseMenuStyle(tp);
+            break;
+         case TOK_MOVEMODE:
+            ParseMoveMode(tp);
+            break;
+         case TOK_PAGERSTYLE:
+            ParsePagerStyle(tp);
+            break;
+         case TOK_PIXMAPCACHESIZE:
+            SetCacheSize(tp->value);
+            break;
+         case TOK_PLACEMENTMODE:
+            ParsePlacementMode(tp);
+            break;
+         case TOK_POPUPSTYLE:
+            ParsePopupStyle(tp);
+            break;
+         case TOK_RESIZEMODE:
+            ParseResizeMode(tp);
+            break;
+         case TOK_RESTARTCOMMAND:
+            AddRestartCommand(tp->value);
+            break;
+         case TOK_ROOTMENU:
+            ParseRootMenu(tp);
+            break;
+         case TOK_SHUTDOWNCOMMAND:
+            AddShutdownCommand(tp->value);
+            break;
+         case TOK_SNAPMODE:
+            ParseSnapMode(tp);
+            break;
+         case TOK_STARTUPCOMMAND:
+            AddStartupCommand(tp->value,
+               FindAttribute(tp->attributes, AFTER_ATTRIBUTE));
+            break;
+         case TOK_TASKLISTSTYLE:
+            ParseTaskListStyle(tp);
+            break;
+         case TOK_TRAY:
+            ParseTray(tp);
+            break;
+         case TOK_TRAYSTYLE:
+            ParseTrayStyle(tp);
+            break;
+         case TOK_TRAYBUTTONSTYLE:
+            ParseTrayButtonStyle(tp);
+            break;
+         case TOK_CLOCKSTYLE:
+            ParseClockStyle(tp);
+            break;
+         case TOK_WINDOWSTYLE:
+            ParseWindowStyle(tp);
+            break;
+         case TOK_BUTTONCLOSE:
+            SetButtonMask(BP_CLOSE, tp->value);
+            break;
+         case TOK_BUTTONMIN:
+            SetButtonMask(BP_MINIMIZE, tp->value);
+            break;
+         case TOK_BUTTONMAX:
+            SetButtonMask(BP_MAXIMIZE, tp->value);
+            break;
+         case TOK_BUTTONMAXACTIVE:
+            SetButtonMask(BP_MAXIMIZE_ACTIVE, tp->value);
+            break;
+         default:
+            InvalidTag(tp, TOK_JWM);
+            break;
          }
       }
    } else {
@@ -413,6 +796,21 @@ void ParseFocusModel(const TokenNode *tp) {
    }
 }
 
+/** Parse the placement mode for new windows. */
+void ParsePlacementMode(const TokenNode *tp) {
+   if(JLIKELY(tp->value)) {
+      if(!strcmp(tp->value, "cascade")) {
+         SetPlacementMode(PLACE_CASCADE);
+      } else if(!strcmp(tp->value, "smart")) {
+         SetPlacementMode(PLACE_SMART);
+      } else {
+         ParseError(tp, "invalid placement mode: \"%s\"", tp->value);
+      }
+   } else {
+      ParseError(tp, "placement mode not specified");
+   }
+}
+
 /** Parse snap mode for moving windows. */
 void ParseSnapMode(const TokenNode *tp) {
 
@@ -448,6 +846,8 @@ void ParseMoveMode(const TokenNode *tp) {
    str = FindAttribute(tp->attributes, COORDINATES_ATTRIBUTE);
    SetMoveStatusType(str);
 
+   SetMoveRate(FindAttribute(tp->attributes, RATE_ATTRIBUTE));
+
    if(JLIKELY(tp->value)) {
       if(!strcmp(tp->value, "outline")) {
          SetMoveMode(MOVE_OUTLINE);
@@ -470,6 +870,8 @@ void ParseResizeMode(const TokenNode *tp) {
    str = FindAttribute(tp->attributes, COORDINATES_ATTRIBUTE);
    SetResizeStatusType(str);
 
+   SetResizeRate(FindAttribute(tp->attributes, RATE_ATTRIBUTE));
+
    if(JLIKELY(tp->value)) {
       if(!strcmp(tp->value, "outline")) {
          SetResizeMode(RESIZE_OUTLINE);
@@ -491,6 +893,8 @@ void ParseRootMenu(const TokenNode *start) {
    Menu *menu;
 
    menu = Allocate(sizeof(Menu));
+   menu->items = NULL;
+   InitializeMenu(menu);
 
    value = FindAttribute(start->attributes, HEIGHT_ATTRIBUTE);
    if(value) {
@@ -510,7 +914,6 @@ void ParseRootMenu(const TokenNode *start) {
       menu->label = NULL;
    }
 
-   menu->items = NULL;
    ParseMenuItem(start->subnodeHead, menu, NULL);
 
    value = FindAttribute(start->attributes, ONROOT_ATTRIBUTE);
@@ -534,6 +937,7 @@ MenuItem *InsertMenuItem(MenuItem *last) {
    item->action.type = MA_NONE;
    item->action.data.str = NULL;
    item->submenu = NULL;
+   item->icon = NULL;
 
    item->next = NULL;
    if(last) {
@@ -577,6 +981,8 @@ MenuItem *ParseMenuItem(const TokenNode *start, Menu *menu,
 
          last->submenu = Allocate(sizeof(Menu));
          child = last->submenu;
+         child->items = NULL;
+         InitializeMenu(child);
 
          value = FindAttribute(start->attributes, HEIGHT_ATTRIBUTE);
          if(value) {
@@ -596,8 +1002,7 @@ MenuItem *ParseMenuItem(const TokenNode *start, Menu *menu,
             child->label = NULL;
          }
 
-         last->submenu->items = NULL;
-         ParseMenuItem(start->subnodeHead, last->submenu, NULL);
+         ParseMenuItem(start->subnodeHead, child, NULL);
 
          break;
       case TOK_PROGRAM:
@@ -987,9 +1392,11 @@ void ParseDesktops(const TokenNode *tp) {
 
    Assert(tp);
 
-   width = FindAttribute(tp->attributes, WIDTH_ATTRIBUTE);
-   height = FindAttribute(tp->attributes, HEIGHT_ATTRIBUTE);
-   SetDesktopCount(width, height);
+   if(PARSING(SECTION_OTHER)) {
+      width = FindAttribute(tp->attributes, WIDTH_ATTRIBUTE);
+      height = FindAttribute(tp->attributes, HEIGHT_ATTRIBUTE);
+      SetDesktopCount(width, height);
+   }
 
    desktop = 0;
    for(x = 0, np = tp->subnodeHead; np; np = np->next, x++) {
@@ -998,14 +1405,18 @@ void ParseDesktops(const TokenNode *tp) {
       }
       switch(np->type) {
       case TOK_BACKGROUND:
-         ParseDesktopBackground(-1, np);
+         if(PARSING(SECTION_BACKGROUNDS)) {
+            ParseDesktopBackground(-1, np);
+         }
          break;
       case TOK_DESKTOP:
          ParseDesktop(desktop, np);
          ++desktop;
          break;
       default:
-         InvalidTag(np, TOK_DESKTOPS);
+         if(PARSING(SECTION_OTHER)) {
+            InvalidTag(np, TOK_DESKTOPS);
+         }
          break;
       }
    }
@@ -1019,17 +1430,21 @@ void ParseDesktop(int desktop, const TokenNode *tp) {
    const char *attr;
 
    attr = FindAttribute(tp->attributes, NAME_ATTRIBUTE);
-   if(attr) {
+   if(attr && PARSING(SECTION_OTHER)) {
       SetDesktopName(desktop, attr);
    }
 
    for(np = tp->subnodeHead; np; np = np->next) {
       switch(np->type) {
       case TOK_BACKGROUND:
-         ParseDesktopBackground(desktop, np);
+         if(PARSING(SECTION_BACKGROUNDS)) {
+            ParseDesktopBackground(desktop, np);
+         }
          break;
       default:
-         InvalidTag(np, TOK_DESKTOP);
+         if(PARSING(SECTION_OTHER)) {
+            InvalidTag(np, TOK_DESKTOP);
+         }
          break;
       }
    }
@@ -1759,6 +2174,7 @@ void ParseError(const TokenNode *tp, const char *str, ...) {
    }
 
    WarningVA(msg, str, ap);
+   parseErrorCount += 1;
 
    Release(msg);
 
@@ -15,5 +15,12 @@
  */
 void ParseConfig(const char *fileName);
 
+/** Reload a configuration file.
+ * Only the parts of the configuration that changed since the last
+ * parse are applied. Nothing is applied if the file has errors.
+ * @param fileName The file to parse.
+ */
+void ReloadConfig(const char *fileName);
+
 #endif /* PARSE_H */
 
@@ -14,6 +14,8 @@
 #include "border.h"
 #include "tray.h"
 #include "main.h"
+#include "clientlist.h"
+#include "misc.h"
 
 typedef struct Strut {
    ClientNode *client;
@@ -22,9 +24,18 @@ typedef struct Strut {
    struct Strut *next;
 } Strut;
 
+/** A change in the slope of the overlap as a window moves right. */
+typedef struct OverlapEvent {
+   int x;         /**< Window x-coordinate where the slope changes. */
+   int delta;     /**< Change in slope per unit of vertical overlap. */
+   int index;     /**< The rectangle causing the change. */
+} OverlapEvent;
+
 static Strut *struts = NULL;
 static Strut *strutsTail = NULL;
 
+static PlacementModeType placementMode = PLACE_CASCADE;
+
 /* desktopCount x screenCount */
 /* Note that we assume x and y are 0 based for all screens here. */
 static int *cascadeOffsets = NULL;
@@ -32,8 +43,18 @@ static int *cascadeOffsets = NULL;
 static void SubtractStrutBounds(BoundingBox *box);
 static void SubtractBounds(const BoundingBox *src, BoundingBox *dest);
 
+static void CascadeClient(ClientNode *np, const ScreenType *sp,
+                          const BoundingBox *box, int north, int west);
+static int SmartPlaceClient(ClientNode *np, const BoundingBox *box,
+                            int north, int south, int east, int west);
+static int GetSmartCandidates(int *list, int count,
+                              int start, int size, int limit);
+static int CompareInts(const void *a, const void *b);
+static int CompareOverlapEvents(const void *a, const void *b);
+
 /** Initialize placement data. */
 void InitializePlacement() {
+   placementMode = PLACE_CASCADE;
 }
 
 /** Startup placement. */
@@ -367,13 +388,17 @@ void SubtractStrutBounds(BoundingBox *box) {
 
 }
 
+/** Set the placement mode to use. */
+void SetPlacementMode(PlacementModeType mode) {
+   placementMode = mode;
+}
+
 /** Place a client on the screen. */
 void PlaceClient(ClientNode *np, int alreadyMapped) {
 
    BoundingBox box;
    int north, south, east, west;
    const ScreenType *sp;
-   int cascadeIndex;
    int overflow;
 
    Assert(np);
@@ -400,53 +425,282 @@ void PlaceClient(ClientNode *np, int alreadyMapped) {
       SubtractTrayBounds(GetTrays(), &box, np->state.layer);
       SubtractStrutBounds(&box);
 
-      cascadeIndex = sp->index * desktopCount + currentDesktop;
+      if(placementMode != PLACE_SMART
+         || !SmartPlaceClient(np, &box, north, south, east, west)) {
+         CascadeClient(np, sp, &box, north, west);
+      }
 
-      /* Set the cascaded location. */
-      np->x = box.x + west + cascadeOffsets[cascadeIndex];
-      np->y = box.y + north + cascadeOffsets[cascadeIndex];
-      cascadeOffsets[cascadeIndex] += borderWidth + titleHeight;
+   }
 
-      /* Check for cascade overflow. */
+   if(np->state.status & STAT_FULLSCREEN) {
+      JXMoveWindow(display, np->parent, sp->x, sp->y);
+   } else {
+      JXMoveWindow(display, np->parent, np->x - west, np->y - north);
+   }
+
+}
+
+/** Place a client at the next cascaded location. */
+void CascadeClient(ClientNode *np, const ScreenType *sp,
+                   const BoundingBox *box, int north, int west) {
+
+   int cascadeIndex;
+   int overflow;
+
+   cascadeIndex = sp->index * desktopCount + currentDesktop;
+
+   /* Set the cascaded location. */
+   np->x = box->x + west + cascadeOffsets[cascadeIndex];
+   np->y = box->y + north + cascadeOffsets[cascadeIndex];
+   cascadeOffsets[cascadeIndex] += borderWidth + titleHeight;
+
+   /* Check for cascade overflow. */
+   overflow = 0;
+   if(np->x + np->width - box->x > box->width) {
+      overflow = 1;
+   } else if(np->y + np->height - box->y > box->height) {
+      overflow = 1;
+   }
+
+   if(overflow) {
+
+      cascadeOffsets[cascadeIndex] = borderWidth + titleHeight;
+      np->x = box->x + west + cascadeOffsets[cascadeIndex];
+      np->y = box->y + north + cascadeOffsets[cascadeIndex];
+
+      /* Check for client overflow. */
       overflow = 0;
-      if(np->x + np->width - box.x > box.width) {
+      if(np->x + np->width - box->x > box->width) {
          overflow = 1;
-      } else if(np->y + np->height - box.y > box.height) {
+      } else if(np->y + np->height - box->y > box->height) {
          overflow = 1;
       }
 
+      /* Update cascade position or position client. */
       if(overflow) {
+         np->x = box->x + west;
+         np->y = box->y + north;
+      } else {
+         cascadeOffsets[cascadeIndex] += borderWidth + titleHeight;
+      }
+
+   }
+
+}
+
+/** Place a client where it overlaps the least area of other clients.
+ *
+ * The overlap with one client, as a function of the x-coordinate, is
+ * zero outside of (left - width, right) and concave inside, so the sum
+ * is concave between consecutive interval ends. The minimum is thus at
+ * one of those ends (or at an edge of the bounds) and the same holds
+ * for y. For each candidate y, the overlap is evaluated at every
+ * candidate x in one sweep over the slope changes, which are sorted
+ * once up front. The first position found with the least overlap is
+ * used, scanning from the top-left corner.
+ *
+ * @return 1 if the client was placed, 0 if it does not fit.
+ */
+int SmartPlaceClient(ClientNode *np, const BoundingBox *box,
+                     int north, int south, int east, int west) {
+
+   BoundingBox *rects;
+   OverlapEvent *events;
+   int *xs, *ys;
+   int *weights;
+   ClientNode *tp;
+   int layer;
+   int count, xcount, ycount, ecount;
+   int width, height;
+   int tnorth, tsouth, teast, twest;
+   int x, y, i, e;
+   int left, right, top, bottom;
+   double value, slope, best;
+   int bestx, besty;
+   int pos;
+
+   width = np->width + east + west;
+   height = np->height + north + south;
+   if(width > box->width || height > box->height) {
+      return 0;
+   }
 
-         cascadeOffsets[cascadeIndex] = borderWidth + titleHeight;
-         np->x = box.x + west + cascadeOffsets[cascadeIndex];
-         np->y = box.y + north + cascadeOffsets[cascadeIndex];
+   /* Collect the visible clients, clipped to the bounds. */
+   count = 0;
+   for(layer = 0; layer < LAYER_COUNT; layer++) {
+      for(tp = nodes[layer]; tp; tp = tp->next) {
+         count += 1;
+      }
+   }
+   rects = Allocate((count + 1) * sizeof(BoundingBox));
+   count = 0;
+   for(layer = 0; layer < LAYER_COUNT; layer++) {
+      for(tp = nodes[layer]; tp; tp = tp->next) {
 
-         /* Check for client overflow. */
-         overflow = 0;
-         if(np->x + np->width - box.x > box.width) {
-            overflow = 1;
-         } else if(np->y + np->height - box.y > box.height) {
-            overflow = 1;
+         if(tp == np) {
+            continue;
+         }
+         if(!(tp->state.status & (STAT_MAPPED | STAT_SHADED))) {
+            continue;
+         }
+         if(tp->state.status & (STAT_HIDDEN | STAT_MINIMIZED)) {
+            continue;
          }
 
-         /* Update cascade position or position client. */
-         if(overflow) {
-            np->x = box.x + west;
-            np->y = box.y + north;
+         GetBorderSize(tp, &tnorth, &tsouth, &teast, &twest);
+         left = Max(tp->x - twest, box->x);
+         top = Max(tp->y - tnorth, box->y);
+         right = Min(tp->x + tp->width + teast, box->x + box->width);
+         if(tp->state.status & STAT_SHADED) {
+            bottom = tp->y + tsouth;
          } else {
-            cascadeOffsets[cascadeIndex] += borderWidth + titleHeight;
+            bottom = tp->y + tp->height + tsouth;
+         }
+         bottom = Min(bottom, box->y + box->height);
+         if(left < right && top < bottom) {
+            rects[count].x = left;
+            rects[count].y = top;
+            rects[count].width = right - left;
+            rects[count].height = bottom - top;
+            count += 1;
          }
 
       }
+   }
 
+   xs = Allocate((2 * count + 2) * sizeof(int));
+   ys = Allocate((2 * count + 2) * sizeof(int));
+   events = Allocate((4 * count + 1) * sizeof(OverlapEvent));
+   weights = Allocate((count + 1) * sizeof(int));
+
+   /* Get the candidate locations. */
+   for(i = 0; i < count; i++) {
+      xs[2 * i + 0] = rects[i].x - width;
+      xs[2 * i + 1] = rects[i].x + rects[i].width;
+      ys[2 * i + 0] = rects[i].y - height;
+      ys[2 * i + 1] = rects[i].y + rects[i].height;
    }
+   xcount = GetSmartCandidates(xs, 2 * count, box->x, box->width, width);
+   ycount = GetSmartCandidates(ys, 2 * count, box->y, box->height, height);
+
+   /* The overlap rises from left - width, levels off at left or
+    * right - width, and falls back to zero at right. */
+   ecount = 0;
+   for(i = 0; i < count; i++) {
+      events[ecount].x = rects[i].x - width;
+      events[ecount].delta = 1;
+      events[ecount].index = i;
+      ecount += 1;
+      events[ecount].x = rects[i].x;
+      events[ecount].delta = -1;
+      events[ecount].index = i;
+      ecount += 1;
+      events[ecount].x = rects[i].x + rects[i].width - width;
+      events[ecount].delta = -1;
+      events[ecount].index = i;
+      ecount += 1;
+      events[ecount].x = rects[i].x + rects[i].width;
+      events[ecount].delta = 1;
+      events[ecount].index = i;
+      ecount += 1;
+   }
+   qsort(events, ecount, sizeof(OverlapEvent), CompareOverlapEvents);
+
+   best = -1.0;
+   bestx = box->x;
+   besty = box->y;
+   for(y = 0; y < ycount && best != 0.0; y++) {
+
+      /* Get the vertical overlap with each client for this row. */
+      for(i = 0; i < count; i++) {
+         top = Max(ys[y], rects[i].y);
+         bottom = Min(ys[y] + height, rects[i].y + rects[i].height);
+         weights[i] = Max(bottom - top, 0);
+      }
+
+      /* Sweep across the row. */
+      value = 0.0;
+      slope = 0.0;
+      pos = box->x - width;
+      e = 0;
+      for(x = 0; x < xcount; x++) {
+         while(e < ecount && events[e].x <= xs[x]) {
+            value += slope * (events[e].x - pos);
+            pos = events[e].x;
+            slope += (double)events[e].delta * weights[events[e].index];
+            e += 1;
+         }
+         value += slope * (xs[x] - pos);
+         pos = xs[x];
+         if(best < 0.0 || value < best) {
+            best = value;
+            bestx = xs[x];
+            besty = ys[y];
+            if(best == 0.0) {
+               break;
+            }
+         }
+      }
 
-   if(np->state.status & STAT_FULLSCREEN) {
-      JXMoveWindow(display, np->parent, sp->x, sp->y);
-   } else {
-      JXMoveWindow(display, np->parent, np->x - west, np->y - north);
    }
 
+   Release(rects);
+   Release(xs);
+   Release(ys);
+   Release(events);
+   Release(weights);
+
+   np->x = bestx + west;
+   np->y = besty + north;
+
+   return 1;
+
+}
+
+/** Sort and filter candidate coordinates for smart placement.
+ * @param list The candidates (with room for two more entries).
+ * @param count The number of candidates.
+ * @param start The first coordinate of the bounds.
+ * @param size The size of the bounds.
+ * @param limit The size of the window being placed.
+ * @return The number of candidates left in the list.
+ */
+int GetSmartCandidates(int *list, int count,
+                       int start, int size, int limit) {
+
+   int x, y;
+
+   list[count++] = start;
+   list[count++] = start + size - limit;
+   qsort(list, count, sizeof(int), CompareInts);
+
+   y = 0;
+   for(x = 0; x < count; x++) {
+      if(list[x] < start || list[x] > start + size - limit) {
+         continue;
+      }
+      if(y > 0 && list[y - 1] == list[x]) {
+         continue;
+      }
+      list[y++] = list[x];
+   }
+
+   return y;
+
+}
+
+/** Compare two integers for qsort. */
+int CompareInts(const void *a, const void *b) {
+   const int ia = *(const int*)a;
+   const int ib = *(const int*)b;
+   return (ia > ib) - (ia < ib);
+}
+
+/** Compare two overlap events for qsort. */
+int CompareOverlapEvents(const void *a, const void *b) {
+   const OverlapEvent *ea = (const OverlapEvent*)a;
+   const OverlapEvent *eb = (const OverlapEvent*)b;
+   return (ea->x > eb->x) - (ea->x < eb->x);
 }
 
 /** Constrain the size of the client so it fits. */
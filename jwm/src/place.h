@@ -14,6 +14,12 @@ struct ClientNode;
 struct ScreenType;
 struct TrayType;
 
+/** Client placement modes. */
+typedef enum {
+   PLACE_CASCADE,    /**< Cascade new windows. */
+   PLACE_SMART       /**< Place new windows where they overlap least. */
+} PlacementModeType;
+
 /** Bounding box. */
 typedef struct BoundingBox {
    int x;         /**< x-coordinate of the bounding box. */
@@ -39,6 +45,11 @@ void RemoveClientStrut(struct ClientNode *np);
  */
 void ReadClientStrut(struct ClientNode *np);
 
+/** Set the placement mode to use.
+ * @param mode The placement mode to use.
+ */
+void SetPlacementMode(PlacementModeType mode);
+
 /** Place a client on the screen.
  * @param np The client to place.
  * @param alreadyMapped 1 if already mapped, 0 if unmapped.
@@ -18,6 +18,7 @@
 #include "timing.h"
 #include "misc.h"
 #include "border.h"
+#include "event.h"
 
 #define DEFAULT_POPUP_DELAY 600
 
@@ -35,6 +36,7 @@ static int popupEnabled;
 int popupDelay;
 
 static void DrawPopup();
+static int ProcessPopupEvent(const XEvent *event, void *data);
 
 /** Initialize popup data. */
 void InitializePopup() {
@@ -56,6 +58,7 @@ void ShutdownPopup() {
       popup.text = NULL;
    }
    if(popup.window != None) {
+      UnregisterEventHandler(popup.window);
       JXDestroyWindow(display, popup.window);
       popup.window = None;
    }
@@ -141,6 +144,7 @@ void ShowPopup(int x, int y, const char *text) {
                                     popup.width, popup.height, 1,
                                     CopyFromParent, InputOutput,
                                     CopyFromParent, attrMask, &attr);
+      RegisterEventHandler(popup.window, ProcessPopupEvent, NULL);
 
    } else {
 
@@ -199,10 +203,10 @@ void SignalPopup(const TimeType *now, int x, int y) {
 
 }
 
-/** Process an event on a popup window. */
-int ProcessPopupEvent(const XEvent *event) {
+/** Process an event on the popup window. */
+int ProcessPopupEvent(const XEvent *event, void *data) {
 
-   if(popup.isActive && event->xany.window == popup.window) {
+   if(popup.isActive) {
       if(event->type == Expose) {
          DrawPopup();
          return 1;
@@ -53,12 +53,6 @@ void SetPopupDelay(const char *str);
  */
 void SignalPopup(const struct TimeType *now, int x, int y);
 
-/** Process a popup event.
- * @param event The event to process.
- * @return 1 if handled, 0 otherwise.
- */
-int ProcessPopupEvent(const XEvent *event);
-
 /** The popup delay in milliseconds. */
 extern int popupDelay;
 
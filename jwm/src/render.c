@@ -114,6 +114,8 @@ ScaledIconNode *CreateScaledRenderIcon(IconNode *icon,
    }
 
    result = Allocate(sizeof(ScaledIconNode));
+   result->icon = icon;
+   result->cache = NULL;
    result->next = icon->nodes;
    icon->nodes = result;
 
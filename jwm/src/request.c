@@ -0,0 +1,378 @@
+/**
+ * @file request.c
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief X requests that need a reply.
+ *
+ * When built with XCB, requests are sent on the XCB connection that
+ * underlies the Xlib display and the replies are collected later.
+ * Errors are returned with the reply rather than passed to the Xlib
+ * error handler. Otherwise the Xlib call is made when the reply is
+ * needed.
+ *
+ */
+
+#include <X11/Xlibint.h>
+#include "jwm.h"
+
+#ifdef USE_XCB
+
+/** Set when a request has been sent since the last reply. */
+static char waiting = 0;
+
+static void CountRoundTrip();
+static Visual *FindVisual(Display *d, VisualID id);
+static int FindScreen(Display *d, Window root);
+
+/** Count a round trip for the first reply after a batch of requests. */
+void CountRoundTrip() {
+   if(waiting) {
+      roundTripCount += 1;
+      waiting = 0;
+   }
+}
+
+/** Send a request for a window property. */
+void RequestProperty(Display *d, PropertyRequest *rp, Window w,
+                     Atom property, long offset, long length, Atom type) {
+   rp->cookie = xcb_get_property(XGetXCBConnection(d), 0, w, property,
+                                 type, offset, length);
+   waiting = 1;
+}
+
+/** Receive a window property. */
+int ReceiveProperty(Display *d, PropertyRequest *rp, Atom *actualType,
+                    int *actualFormat, unsigned long *count,
+                    unsigned long *extra, unsigned char **data) {
+
+   xcb_get_property_reply_t *reply;
+   xcb_generic_error_t *error;
+   const unsigned char *value;
+   unsigned char *result;
+   unsigned long size;
+   unsigned long x;
+   int status;
+
+   CountRoundTrip();
+
+   *actualType = None;
+   *actualFormat = 0;
+   *count = 0;
+   *extra = 0;
+   *data = NULL;
+
+   error = NULL;
+   reply = xcb_get_property_reply(XGetXCBConnection(d), rp->cookie, &error);
+   if(JUNLIKELY(!reply)) {
+      status = error ? error->error_code : BadImplementation;
+      free(error);
+      return status;
+   }
+
+   *actualType = reply->type;
+   *actualFormat = reply->format;
+   *extra = reply->bytes_after;
+   if(reply->type == None) {
+      free(reply);
+      return Success;
+   }
+
+   /* Convert the data to the format returned by Xlib: 16 and 32 bit
+    * values are stored as short and long, and the data is always
+    * terminated so that strings can be used directly. */
+   *count = xcb_get_property_value_length(reply);
+   value = xcb_get_property_value(reply);
+   switch(reply->format) {
+   case 8:
+      size = *count;
+      break;
+   case 16:
+      *count /= 2;
+      size = *count * sizeof(short);
+      break;
+   case 32:
+      *count /= 4;
+      size = *count * sizeof(long);
+      break;
+   default:
+      *count = 0;
+      free(reply);
+      return BadImplementation;
+   }
+
+   result = Xmalloc(size + 1);
+   if(JUNLIKELY(!result)) {
+      *count = 0;
+      free(reply);
+      return BadAlloc;
+   }
+   switch(reply->format) {
+   case 8:
+      memcpy(result, value, size);
+      break;
+   case 16:
+      for(x = 0; x < *count; x++) {
+         ((short*)result)[x] = ((const int16_t*)value)[x];
+      }
+      break;
+   default:
+      for(x = 0; x < *count; x++) {
+         ((unsigned long*)result)[x] = ((const uint32_t*)value)[x];
+      }
+      break;
+   }
+   result[size] = 0;
+   *data = result;
+
+   free(reply);
+   return Success;
+
+}
+
+/** Send a request for the attributes of a window. */
+void RequestWindowAttributes(Display *d, AttributesRequest *rp, Window w) {
+
+   xcb_connection_t *c = XGetXCBConnection(d);
+
+   rp->cookie = xcb_get_window_attributes(c, w);
+   rp->geometry = xcb_get_geometry(c, w);
+   waiting = 1;
+
+}
+
+/** Receive the attributes of a window. */
+Status ReceiveWindowAttributes(Display *d, AttributesRequest *rp,
+                               XWindowAttributes *attr) {
+
+   xcb_connection_t *c = XGetXCBConnection(d);
+   xcb_get_window_attributes_reply_t *reply;
+   xcb_get_geometry_reply_t *geometry;
+   int screen;
+
+   CountRoundTrip();
+
+   reply = xcb_get_window_attributes_reply(c, rp->cookie, NULL);
+   geometry = xcb_get_geometry_reply(c, rp->geometry, NULL);
+   if(JUNLIKELY(!reply || !geometry)) {
+      free(reply);
+      free(geometry);
+      return 0;
+   }
+
+   attr->x = geometry->x;
+   attr->y = geometry->y;
+   attr->width = geometry->width;
+   attr->height = geometry->height;
+   attr->border_width = geometry->border_width;
+   attr->depth = geometry->depth;
+   attr->root = geometry->root;
+   attr->visual = FindVisual(d, reply->visual);
+   attr->class = reply->_class;
+   attr->bit_gravity = reply->bit_gravity;
+   attr->win_gravity = reply->win_gravity;
+   attr->backing_store = reply->backing_store;
+   attr->backing_planes = reply->backing_planes;
+   attr->backing_pixel = reply->backing_pixel;
+   attr->save_under = reply->save_under;
+   attr->colormap = reply->colormap;
+   attr->map_installed = reply->map_is_installed;
+   attr->map_state = reply->map_state;
+   attr->all_event_masks = reply->all_event_masks;
+   attr->your_event_mask = reply->your_event_mask;
+   attr->do_not_propagate_mask = reply->do_not_propagate_mask;
+   attr->override_redirect = reply->override_redirect;
+   screen = FindScreen(d, geometry->root);
+   attr->screen = screen >= 0 ? ScreenOfDisplay(d, screen) : NULL;
+
+   free(reply);
+   free(geometry);
+   return 1;
+
+}
+
+/** Send a request for the pointer location. */
+void RequestPointer(Display *d, PointerRequest *rp, Window w) {
+   rp->cookie = xcb_query_pointer(XGetXCBConnection(d), w);
+   waiting = 1;
+}
+
+/** Receive the pointer location. */
+Bool ReceivePointer(Display *d, PointerRequest *rp,
+                    Window *root, Window *child, int *rootx, int *rooty,
+                    int *winx, int *winy, unsigned int *mask) {
+
+   xcb_query_pointer_reply_t *reply;
+   Bool result;
+
+   CountRoundTrip();
+
+   reply = xcb_query_pointer_reply(XGetXCBConnection(d), rp->cookie, NULL);
+   if(JUNLIKELY(!reply)) {
+      *root = None;
+      *child = None;
+      *rootx = 0;
+      *rooty = 0;
+      *winx = 0;
+      *winy = 0;
+      *mask = 0;
+      return False;
+   }
+
+   *root = reply->root;
+   *child = reply->child;
+   *rootx = reply->root_x;
+   *rooty = reply->root_y;
+   *winx = reply->win_x;
+   *winy = reply->win_y;
+   *mask = reply->mask;
+   result = reply->same_screen ? True : False;
+
+   free(reply);
+   return result;
+
+}
+
+/** Send a request for the children of a window. */
+void RequestTree(Display *d, TreeRequest *rp, Window w) {
+   rp->cookie = xcb_query_tree(XGetXCBConnection(d), w);
+   waiting = 1;
+}
+
+/** Receive the children of a window. */
+Status ReceiveTree(Display *d, TreeRequest *rp, Window *root,
+                   Window *parent, Window **children, unsigned int *count) {
+
+   xcb_query_tree_reply_t *reply;
+   const xcb_window_t *windows;
+   unsigned int x;
+
+   CountRoundTrip();
+
+   *children = NULL;
+   *count = 0;
+
+   reply = xcb_query_tree_reply(XGetXCBConnection(d), rp->cookie, NULL);
+   if(JUNLIKELY(!reply)) {
+      return 0;
+   }
+
+   *root = reply->root;
+   *parent = reply->parent;
+   *count = xcb_query_tree_children_length(reply);
+   if(*count > 0) {
+      *children = Xmalloc(*count * sizeof(Window));
+      if(JUNLIKELY(!*children)) {
+         *count = 0;
+         free(reply);
+         return 0;
+      }
+      windows = xcb_query_tree_children(reply);
+      for(x = 0; x < *count; x++) {
+         (*children)[x] = windows[x];
+      }
+   }
+
+   free(reply);
+   return 1;
+
+}
+
+/** Find the Xlib visual for a visual ID. */
+Visual *FindVisual(Display *d, VisualID id) {
+
+   Screen *sp;
+   int s, x, y;
+
+   for(s = 0; s < ScreenCount(d); s++) {
+      sp = ScreenOfDisplay(d, s);
+      for(x = 0; x < sp->ndepths; x++) {
+         for(y = 0; y < sp->depths[x].nvisuals; y++) {
+            if(sp->depths[x].visuals[y].visualid == id) {
+               return &sp->depths[x].visuals[y];
+            }
+         }
+      }
+   }
+
+   return NULL;
+
+}
+
+/** Find the screen with the specified root window. */
+int FindScreen(Display *d, Window root) {
+
+   int s;
+
+   for(s = 0; s < ScreenCount(d); s++) {
+      if(RootWindow(d, s) == root) {
+         return s;
+      }
+   }
+
+   return -1;
+
+}
+
+#else /* USE_XCB */
+
+/** Save a request for a window property. */
+void RequestProperty(Display *d, PropertyRequest *rp, Window w,
+                     Atom property, long offset, long length, Atom type) {
+   rp->window = w;
+   rp->property = property;
+   rp->offset = offset;
+   rp->length = length;
+   rp->type = type;
+}
+
+/** Get a window property. */
+int ReceiveProperty(Display *d, PropertyRequest *rp, Atom *actualType,
+                    int *actualFormat, unsigned long *count,
+                    unsigned long *extra, unsigned char **data) {
+   roundTripCount += 1;
+   return XGetWindowProperty(d, rp->window, rp->property, rp->offset,
+                             rp->length, False, rp->type, actualType,
+                             actualFormat, count, extra, data);
+}
+
+/** Save a request for the attributes of a window. */
+void RequestWindowAttributes(Display *d, AttributesRequest *rp, Window w) {
+   rp->window = w;
+}
+
+/** Get the attributes of a window. */
+Status ReceiveWindowAttributes(Display *d, AttributesRequest *rp,
+                               XWindowAttributes *attr) {
+   roundTripCount += 1;
+   return XGetWindowAttributes(d, rp->window, attr);
+}
+
+/** Save a request for the pointer location. */
+void RequestPointer(Display *d, PointerRequest *rp, Window w) {
+   rp->window = w;
+}
+
+/** Get the pointer location. */
+Bool ReceivePointer(Display *d, PointerRequest *rp,
+                    Window *root, Window *child, int *rootx, int *rooty,
+                    int *winx, int *winy, unsigned int *mask) {
+   roundTripCount += 1;
+   return XQueryPointer(d, rp->window, root, child, rootx, rooty,
+                        winx, winy, mask);
+}
+
+/** Save a request for the children of a window. */
+void RequestTree(Display *d, TreeRequest *rp, Window w) {
+   rp->window = w;
+}
+
+/** Get the children of a window. */
+Status ReceiveTree(Display *d, TreeRequest *rp, Window *root,
+                   Window *parent, Window **children, unsigned int *count) {
+   roundTripCount += 1;
+   return XQueryTree(d, rp->window, root, parent, children, count);
+}
+
+#endif /* USE_XCB */
+
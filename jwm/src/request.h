@@ -0,0 +1,104 @@
+/**
+ * @file request.h
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Header for X requests that need a reply.
+ *
+ * These requests are split into a call that sends the request and a
+ * call that waits for the reply so that several requests can be sent
+ * before waiting. With XCB, the request is sent right away and one
+ * round trip covers all of the replies. With Xlib, the whole request
+ * is made when the reply is received. Every request must be received.
+ *
+ */
+
+#ifndef REQUEST_H
+#define REQUEST_H
+
+/** A GetProperty request. */
+typedef struct PropertyRequest {
+#ifdef USE_XCB
+   xcb_get_property_cookie_t cookie;
+#else
+   Window window;
+   Atom property;
+   long offset;
+   long length;
+   Atom type;
+#endif
+} PropertyRequest;
+
+/** A request for the attributes (and geometry) of a window. */
+typedef struct AttributesRequest {
+#ifdef USE_XCB
+   xcb_get_window_attributes_cookie_t cookie;
+   xcb_get_geometry_cookie_t geometry;
+#else
+   Window window;
+#endif
+} AttributesRequest;
+
+/** A QueryPointer request. */
+typedef struct PointerRequest {
+#ifdef USE_XCB
+   xcb_query_pointer_cookie_t cookie;
+#else
+   Window window;
+#endif
+} PointerRequest;
+
+/** A QueryTree request. */
+typedef struct TreeRequest {
+#ifdef USE_XCB
+   xcb_query_tree_cookie_t cookie;
+#else
+   Window window;
+#endif
+} TreeRequest;
+
+/** Send a request for a window property.
+ * The arguments are those of XGetWindowProperty (the property is
+ * never deleted).
+ */
+void RequestProperty(Display *d, PropertyRequest *rp, Window w,
+                     Atom property, long offset, long length, Atom type);
+
+/** Receive a window property.
+ * The results are those of XGetWindowProperty.
+ * @return Success or an error code.
+ */
+int ReceiveProperty(Display *d, PropertyRequest *rp, Atom *actualType,
+                    int *actualFormat, unsigned long *count,
+                    unsigned long *extra, unsigned char **data);
+
+/** Send a request for the attributes of a window. */
+void RequestWindowAttributes(Display *d, AttributesRequest *rp, Window w);
+
+/** Receive the attributes of a window.
+ * @return Non-zero on success, zero if the window does not exist.
+ */
+Status ReceiveWindowAttributes(Display *d, AttributesRequest *rp,
+                               XWindowAttributes *attr);
+
+/** Send a request for the pointer location. */
+void RequestPointer(Display *d, PointerRequest *rp, Window w);
+
+/** Receive the pointer location.
+ * The results are those of XQueryPointer.
+ */
+Bool ReceivePointer(Display *d, PointerRequest *rp,
+                    Window *root, Window *child, int *rootx, int *rooty,
+                    int *winx, int *winy, unsigned int *mask);
+
+/** Send a request for the children of a window. */
+void RequestTree(Display *d, TreeRequest *rp, Window w);
+
+/** Receive the children of a window.
+ * The results are those of XQueryTree (children is freed with XFree).
+ */
+Status ReceiveTree(Display *d, TreeRequest *rp, Window *root,
+                   Window *parent, Window **children, unsigned int *count);
+
+#endif /* REQUEST_H */
+
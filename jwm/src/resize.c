@@ -19,21 +19,73 @@
 #include "key.h"
 #include "event.h"
 #include "border.h"
+#include "hint.h"
+#include "timing.h"
+#include "error.h"
+
+/** Default number of opaque resize frames per second. */
+#define DEFAULT_RESIZE_RATE 60
+
+/** Milliseconds to wait for a client to answer a sync request. */
+#define SYNC_TIMEOUT 500
 
 static ResizeModeType resizeMode = RESIZE_OPAQUE;
+static unsigned int resizeDelay = 1000 / DEFAULT_RESIZE_RATE;
 
 static char shouldStopResize;
 
+/* Opaque resizes are sent to the client at most once per frame.
+ * Clients supporting _NET_WM_SYNC_REQUEST get a new size only after
+ * they have handled the previous one.
+ */
+static char resizePending;
+static char resizeWaiting;
+static TimeType lastResize;
+
+#ifdef USE_XSYNC
+static XSyncAlarm syncAlarm = None;
+static XSyncValue syncValue;
+#endif
+
 static void StopResize(ClientNode *np);
 static void ResizeController(int wasDestroyed);
 static void FixWidth(ClientNode *np);
 static void FixHeight(ClientNode *np);
+static void ApplyResize(ClientNode *np);
+static void StartResizeSync(ClientNode *np);
+static void StopResizeSync();
+static void SendSyncRequest(ClientNode *np);
+static void HandleResizeSync(const XEvent *event);
+static void FlushResize(ClientNode *np);
+static unsigned int GetResizeWait();
 
 /** Set the resize mode to use. */
 void SetResizeMode(ResizeModeType mode) {
    resizeMode = mode;
 }
 
+/** Set the maximum number of opaque resize frames per second. */
+void SetResizeRate(const char *value) {
+
+   int temp;
+
+   if(!value) {
+      resizeDelay = 1000 / DEFAULT_RESIZE_RATE;
+      return;
+   }
+
+   temp = atoi(value);
+   if(JUNLIKELY(temp < 0)) {
+      Warning(_("invalid resize rate specified: %d"), temp);
+      resizeDelay = 1000 / DEFAULT_RESIZE_RATE;
+   } else if(temp == 0) {
+      resizeDelay = 0;
+   } else {
+      resizeDelay = 1000 / temp;
+   }
+
+}
+
 /** Callback to stop a resize. */
 void ResizeController(int wasDestroyed) {
    if(resizeMode == RESIZE_OUTLINE) {
@@ -42,6 +94,7 @@ void ResizeController(int wasDestroyed) {
    JXUngrabPointer(display, CurrentTime);
    JXUngrabKeyboard(display, CurrentTime);
    DestroyResizeWindow();
+   StopResizeSync();
    shouldStopResize = 1;
 }
 
@@ -97,8 +150,20 @@ void ResizeClient(ClientNode *np, BorderActionType action,
       return;
    }
 
+   if(resizeMode == RESIZE_OPAQUE) {
+      StartResizeSync(np);
+   }
+
    for(;;) {
 
+      /* Send the latest size once the client is ready for it. */
+      if(resizePending) {
+         FlushResize(np);
+         if(resizePending && !PollForEvent(GetResizeWait())) {
+            continue;
+         }
+      }
+
       WaitForEvent(&event);
 
       if(shouldStopResize) {
@@ -209,7 +274,6 @@ void ResizeClient(ClientNode *np, BorderActionType action,
             UpdateResizeWindow(np, gwidth, gheight);
 
             if(resizeMode == RESIZE_OUTLINE) {
-               ClearOutline();
                if(np->state.status & STAT_SHADED) {
                   DrawOutline(np->x - west, np->y - north,
                      np->width + west + east, north + south);
@@ -219,26 +283,7 @@ void ResizeClient(ClientNode *np, BorderActionType action,
                      np->height + north + south);
                }
             } else {
-               ResetRoundedRectWindow(np->parent);
-               if(np->state.status & STAT_SHADED) {
-                  ShapeRoundedRectWindow(np->parent, 
-                     np->width + east + west,
-                     north + south);
-                  JXMoveResizeWindow(display, np->parent,
-                     np->x - west, np->y - north,
-                     np->width + west + east, north + south);
-               } else {
-                  ShapeRoundedRectWindow(np->parent, 
-                     np->width + east + west,
-                     np->height + north + south);
-                  JXMoveResizeWindow(display, np->parent,
-                     np->x - west, np->y - north,
-                     np->width + west + east,
-                     np->height + north + south);
-               }
-               JXMoveResizeWindow(display, np->window, west,
-                  north, np->width, np->height);
-               SendConfigureEvent(np);
+               resizePending = 1;
             }
 
             UpdatePager();
@@ -247,6 +292,7 @@ void ResizeClient(ClientNode *np, BorderActionType action,
 
          break;
       default:
+         HandleResizeSync(&event);
          break;
       }
    }
@@ -385,7 +431,6 @@ void ResizeClientKeyboard(ClientNode *np) {
          UpdateResizeWindow(np, gwidth, gheight);
 
          if(resizeMode == RESIZE_OUTLINE) {
-            ClearOutline();
             if(np->state.status & STAT_SHADED) {
                DrawOutline(np->x - west, np->y - north,
                   np->width + west + east,
@@ -425,8 +470,6 @@ void ResizeClientKeyboard(ClientNode *np) {
 /** Stop a resize action. */
 void StopResize(ClientNode *np) {
 
-   int north, south, east, west;
-
    np->controller = NULL;
 
    if(resizeMode == RESIZE_OUTLINE) {
@@ -437,6 +480,16 @@ void StopResize(ClientNode *np) {
    JXUngrabKeyboard(display, CurrentTime);
 
    DestroyResizeWindow();
+   StopResizeSync();
+
+   ApplyResize(np);
+
+}
+
+/** Move and resize the frame and client window to the client size. */
+void ApplyResize(ClientNode *np) {
+
+   int north, south, east, west;
 
    GetBorderSize(np, &north, &south, &east, &west);
 
@@ -464,6 +517,167 @@ void StopResize(ClientNode *np) {
 
 }
 
+/** Send the pending size if the client is ready for another frame. */
+void FlushResize(ClientNode *np) {
+
+   if(GetResizeWait() > 0) {
+      return;
+   }
+
+   resizePending = 0;
+   resizeWaiting = 0;
+   GetCurrentTime(&lastResize);
+
+   SendSyncRequest(np);
+   ApplyResize(np);
+
+}
+
+/** Get the time in milliseconds until the next frame can be sent. */
+unsigned int GetResizeWait() {
+
+   TimeType now;
+   unsigned long elapsed;
+
+   GetCurrentTime(&now);
+   elapsed = GetTimeDifference(&now, &lastResize);
+
+   if(resizeWaiting) {
+      /* Give up on clients that stop answering. */
+      if(elapsed < SYNC_TIMEOUT) {
+         return SYNC_TIMEOUT - elapsed;
+      }
+      return 0;
+   }
+
+#ifdef USE_XSYNC
+   /* Clients using sync requests set their own pace. */
+   if(syncAlarm != None) {
+      return 0;
+   }
+#endif
+
+   if(elapsed < resizeDelay) {
+      return resizeDelay - elapsed;
+   }
+   return 0;
+
+}
+
+/** Set up _NET_WM_SYNC_REQUEST for a client if it supports it. */
+void StartResizeSync(ClientNode *np) {
+
+#ifdef USE_XSYNC
+   XSyncAlarmAttributes attr;
+   unsigned long counter;
+#endif
+
+   resizePending = 0;
+   resizeWaiting = 0;
+   lastResize.seconds = 0;
+   lastResize.ms = 0;
+
+#ifdef USE_XSYNC
+
+   syncAlarm = None;
+   if(!haveSync || !(ReadWMProtocols(np->window) & PROT_SYNC_REQUEST)) {
+      return;
+   }
+   if(!GetCardinalAtom(np->window, ATOM_NET_WM_SYNC_REQUEST_COUNTER,
+                       &counter) || counter == None) {
+      return;
+   }
+   if(!JXSyncQueryCounter(display, (XSyncCounter)counter, &syncValue)) {
+      return;
+   }
+
+   attr.trigger.counter = (XSyncCounter)counter;
+   attr.trigger.value_type = XSyncAbsolute;
+   attr.trigger.wait_value = syncValue;
+   attr.trigger.test_type = XSyncPositiveComparison;
+   XSyncIntToValue(&attr.delta, 0);
+   attr.events = True;
+   syncAlarm = JXSyncCreateAlarm(display,
+      XSyncCACounter | XSyncCAValueType | XSyncCAValue
+      | XSyncCATestType | XSyncCADelta | XSyncCAEvents, &attr);
+
+#endif
+
+}
+
+/** Stop using _NET_WM_SYNC_REQUEST. */
+void StopResizeSync() {
+
+   resizePending = 0;
+   resizeWaiting = 0;
+
+#ifdef USE_XSYNC
+   if(syncAlarm != None) {
+      JXSyncDestroyAlarm(display, syncAlarm);
+      syncAlarm = None;
+   }
+#endif
+
+}
+
+/** Ask the client to tell us when it has handled the next size. */
+void SendSyncRequest(ClientNode *np) {
+
+#ifdef USE_XSYNC
+
+   XSyncAlarmAttributes attr;
+   XEvent event;
+   XSyncValue one;
+   Bool overflow;
+
+   if(syncAlarm == None) {
+      return;
+   }
+
+   XSyncIntToValue(&one, 1);
+   XSyncValueAdd(&syncValue, syncValue, one, &overflow);
+
+   attr.trigger.wait_value = syncValue;
+   JXSyncChangeAlarm(display, syncAlarm, XSyncCAValue, &attr);
+
+   memset(&event, 0, sizeof(event));
+   event.xclient.type = ClientMessage;
+   event.xclient.window = np->window;
+   event.xclient.message_type = atoms[ATOM_WM_PROTOCOLS];
+   event.xclient.format = 32;
+   event.xclient.data.l[0] = atoms[ATOM_NET_WM_SYNC_REQUEST];
+   event.xclient.data.l[1] = eventTime;
+   event.xclient.data.l[2] = XSyncValueLow32(syncValue);
+   event.xclient.data.l[3] = XSyncValueHigh32(syncValue);
+   JXSendEvent(display, np->window, False, NoEventMask, &event);
+
+   resizeWaiting = 1;
+
+#endif
+
+}
+
+/** Check for an alarm telling us the client finished a frame. */
+void HandleResizeSync(const XEvent *event) {
+
+#ifdef USE_XSYNC
+
+   const XSyncAlarmNotifyEvent *alarm;
+
+   if(syncAlarm == None || event->type != syncEvent + XSyncAlarmNotify) {
+      return;
+   }
+
+   alarm = (const XSyncAlarmNotifyEvent*)event;
+   if(alarm->alarm == syncAlarm
+      && XSyncValueGreaterOrEqual(alarm->counter_value, syncValue)) {
+      resizeWaiting = 0;
+   }
+
+#endif
+
+}
+
 /** Fix the width to match the aspect ratio. */
 void FixWidth(ClientNode *np) {
 
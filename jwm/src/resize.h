@@ -39,5 +39,11 @@ void ResizeClientKeyboard(struct ClientNode *np);
  */
 void SetResizeMode(ResizeModeType mode);
 
+/** Set the maximum number of opaque resize frames per second.
+ * Clients that support _NET_WM_SYNC_REQUEST are not limited.
+ * @param value The rate (0 for no limit, NULL for the default).
+ */
+void SetResizeRate(const char *value);
+
 #endif /* RESIZE_H */
 
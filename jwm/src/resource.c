@@ -0,0 +1,455 @@
+/**
+ * @file resource.c
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief X resource accounting.
+ *
+ * Every pixmap, window, GC, picture, cursor and font created through
+ * the JX wrappers is kept in a table with the file that created it.
+ * The report groups them by subsystem with an estimate of the server
+ * memory used, followed by the heap use of JWM itself.
+ *
+ */
+
+#include "jwm.h"
+#include "resource.h"
+#include "main.h"
+#include "hint.h"
+#include "cache.h"
+
+/** Size of the resource hash table. */
+#define RESOURCE_HASH_SIZE 256
+
+/** Maximum number of subsystems in a report. */
+#define MAX_SUBSYSTEMS 64
+
+/** Maximum length of a line in the report. */
+#define REPORT_LINE_SIZE 256
+
+/** Rough server memory for resources other than pixmaps. */
+#define WINDOW_SIZE  512
+#define GC_SIZE      256
+#define PICTURE_SIZE 128
+#define CURSOR_SIZE  512
+#define FONT_SIZE    0
+
+/** A resource created by JWM. */
+typedef struct ResourceNode {
+   unsigned long id;             /**< XID or pointer. */
+   unsigned long size;           /**< Estimated server memory. */
+   const char *file;             /**< Source file that created it. */
+   ResourceType type;            /**< The kind of resource. */
+   struct ResourceNode *next;    /**< Next in the hash chain. */
+} ResourceNode;
+
+/** Resources and heap use of one subsystem in a report. */
+typedef struct SubsystemNode {
+   char name[16];                      /**< Source file without ".c". */
+   unsigned long count[RESOURCE_COUNT];   /**< Resources by type. */
+   unsigned long bytes;                /**< Estimated server memory. */
+   unsigned long heapBytes;            /**< Live heap (debug builds). */
+   unsigned long heapBlocks;           /**< Live blocks (debug builds). */
+} SubsystemNode;
+
+static const char *RESOURCE_NAMES[RESOURCE_COUNT] = {
+   "pixmaps", "windows", "GCs", "pictures", "cursors", "fonts"
+};
+
+static const unsigned long RESOURCE_SIZES[RESOURCE_COUNT] = {
+   0, WINDOW_SIZE, GC_SIZE, PICTURE_SIZE, CURSOR_SIZE, FONT_SIZE
+};
+
+static ResourceNode *resources[RESOURCE_HASH_SIZE];
+static volatile sig_atomic_t shouldReport = 0;
+
+static SubsystemNode *subsystems;
+static unsigned int subsystemCount;
+
+static unsigned int GetResourceHash(ResourceType type, unsigned long id);
+static void AddResource(ResourceType type, unsigned long id,
+                        unsigned long size, const char *file);
+static SubsystemNode *GetSubsystem(const char *file);
+static int CompareSubsystems(const void *a, const void *b);
+static char *CreateReport(size_t *length);
+static void AppendReport(char **report, size_t *length,
+                         const char *format, ...);
+static void HandleReport(int sig);
+
+#ifdef DEBUG
+static void AddHeapSite(const char *file, size_t bytes,
+                        unsigned int blocks);
+#endif
+
+/** Initialize resource data. */
+void InitializeResources() {
+}
+
+/** Startup resource accounting. */
+void StartupResources() {
+
+   struct sigaction sa;
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = HandleReport;
+   sigaction(SIGUSR2, &sa, NULL);
+
+}
+
+/** Shutdown resource accounting. */
+void ShutdownResources() {
+
+   struct sigaction sa;
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = SIG_DFL;
+   sigaction(SIGUSR2, &sa, NULL);
+
+}
+
+/** Destroy resource data.
+ * The table is kept since resources like the root GC outlive a restart.
+ */
+void DestroyResources() {
+}
+
+/** Get the hash of a resource. */
+unsigned int GetResourceHash(ResourceType type, unsigned long id) {
+   id ^= id >> 12;
+   id ^= id >> 4;
+   return (unsigned int)(id + type) & (RESOURCE_HASH_SIZE - 1);
+}
+
+/** Add a resource to the table. */
+void AddResource(ResourceType type, unsigned long id,
+                 unsigned long size, const char *file) {
+
+   ResourceNode *rp;
+   unsigned int hash;
+
+   hash = GetResourceHash(type, id);
+   rp = Allocate(sizeof(ResourceNode));
+   rp->id = id;
+   rp->size = size;
+   rp->file = file;
+   rp->type = type;
+   rp->next = resources[hash];
+   resources[hash] = rp;
+
+}
+
+/** Record a resource. */
+unsigned long TrackResource(ResourceType type, unsigned long id,
+                            const char *file) {
+   if(id != None) {
+      AddResource(type, id, RESOURCE_SIZES[type], file);
+   }
+   return id;
+}
+
+/** Record a resource known by a client-side pointer. */
+void *TrackPointer(ResourceType type, void *ptr, const char *file) {
+   if(ptr) {
+      AddResource(type, (unsigned long)ptr, RESOURCE_SIZES[type], file);
+   }
+   return ptr;
+}
+
+/** Forget a resource that is about to be freed. */
+unsigned long UntrackResource(ResourceType type, unsigned long id) {
+
+   ResourceNode **rpp;
+   ResourceNode *rp;
+
+   for(rpp = &resources[GetResourceHash(type, id)]; *rpp;
+       rpp = &(*rpp)->next) {
+      rp = *rpp;
+      if(rp->id == id && rp->type == type) {
+         *rpp = rp->next;
+         Release(rp);
+         break;
+      }
+   }
+
+   return id;
+
+}
+
+/** Forget a resource known by a pointer that is about to be freed. */
+void *UntrackPointer(ResourceType type, void *ptr) {
+   UntrackResource(type, (unsigned long)ptr);
+   return ptr;
+}
+
+/** Create a pixmap and record it with its size. */
+Pixmap CreateTrackedPixmap(Display *d, Drawable drawable,
+                           unsigned int width, unsigned int height,
+                           unsigned int depth, const char *file) {
+
+   Pixmap result;
+
+   result = XCreatePixmap(d, drawable, width, height, depth);
+   AddResource(RESOURCE_PIXMAP, result,
+               GetPixmapSize(width, height, depth), file);
+
+   return result;
+
+}
+
+/** Create a bitmap from data and record it with its size. */
+Pixmap CreateTrackedBitmap(Display *d, Drawable drawable, const char *data,
+                           unsigned int width, unsigned int height,
+                           const char *file) {
+
+   Pixmap result;
+
+   result = XCreateBitmapFromData(d, drawable, data, width, height);
+   if(result != None) {
+      AddResource(RESOURCE_PIXMAP, result,
+                  GetPixmapSize(width, height, 1), file);
+   }
+
+   return result;
+
+}
+
+/** Create a pixmap from bitmap data and record it with its size. */
+Pixmap CreateTrackedPixmapFromBitmap(Display *d, Drawable drawable,
+                                     char *data, unsigned int width,
+                                     unsigned int height, unsigned long fg,
+                                     unsigned long bg, unsigned int depth,
+                                     const char *file) {
+
+   Pixmap result;
+
+   result = XCreatePixmapFromBitmapData(d, drawable, data, width, height,
+                                        fg, bg, depth);
+   if(result != None) {
+      AddResource(RESOURCE_PIXMAP, result,
+                  GetPixmapSize(width, height, depth), file);
+   }
+
+   return result;
+
+}
+
+/** Forget all resources. */
+void ForgetResources() {
+
+   ResourceNode *rp;
+   int x;
+
+   for(x = 0; x < RESOURCE_HASH_SIZE; x++) {
+      while(resources[x]) {
+         rp = resources[x]->next;
+         Release(resources[x]);
+         resources[x] = rp;
+      }
+   }
+
+}
+
+/** Store a report of X resources and heap use on the root window. */
+void WriteResourceReport() {
+
+   char *report;
+   size_t length;
+
+   report = CreateReport(&length);
+   JXChangeProperty(display, rootWindow, atoms[ATOM_JWM_REPORT],
+                    XA_STRING, 8, PropModeReplace,
+                    (unsigned char*)report, length);
+   Release(report);
+
+}
+
+/** Write the report to stderr if one was requested. */
+void SignalResources() {
+
+   char *report;
+   size_t length;
+
+   if(shouldReport) {
+      shouldReport = 0;
+      report = CreateReport(&length);
+      fputs(report, stderr);
+      Release(report);
+   }
+
+}
+
+/** Signal handler to request a report. */
+void HandleReport(int sig) {
+   shouldReport = 1;
+}
+
+/** Get the report row for a source file, adding it if needed. */
+SubsystemNode *GetSubsystem(const char *file) {
+
+   const char *name;
+   size_t len;
+   unsigned int x;
+
+   name = strrchr(file, '/');
+   name = name ? name + 1 : file;
+   len = strcspn(name, ".");
+   if(len >= sizeof(subsystems[0].name)) {
+      len = sizeof(subsystems[0].name) - 1;
+   }
+
+   for(x = 0; x < subsystemCount; x++) {
+      if(!strncmp(subsystems[x].name, name, len)
+         && subsystems[x].name[len] == 0) {
+         return &subsystems[x];
+      }
+   }
+
+   /* Everything past the limit is lumped into the last row. */
+   if(subsystemCount == MAX_SUBSYSTEMS) {
+      return &subsystems[MAX_SUBSYSTEMS - 1];
+   }
+
+   memset(&subsystems[x], 0, sizeof(SubsystemNode));
+   memcpy(subsystems[x].name, name, len);
+   subsystemCount += 1;
+   return &subsystems[x];
+
+}
+
+#ifdef DEBUG
+/** Add the live heap of an allocation site to its subsystem. */
+void AddHeapSite(const char *file, size_t bytes, unsigned int blocks) {
+
+   SubsystemNode *sp;
+
+   sp = GetSubsystem(file);
+   sp->heapBytes += bytes;
+   sp->heapBlocks += blocks;
+
+}
+#endif
+
+/** Compare subsystems by server memory and then by heap use. */
+int CompareSubsystems(const void *a, const void *b) {
+
+   const SubsystemNode *sa = (const SubsystemNode*)a;
+   const SubsystemNode *sb = (const SubsystemNode*)b;
+
+   if(sa->bytes != sb->bytes) {
+      return sa->bytes < sb->bytes ? 1 : -1;
+   }
+   if(sa->heapBytes != sb->heapBytes) {
+      return sa->heapBytes < sb->heapBytes ? 1 : -1;
+   }
+   return strcmp(sa->name, sb->name);
+
+}
+
+/** Build the report. */
+char *CreateReport(size_t *length) {
+
+   SubsystemNode total;
+   SubsystemNode *sp;
+   ResourceNode *rp;
+   char *report;
+   unsigned int x;
+   int y;
+#ifdef HAVE_MALLINFO2
+   struct mallinfo2 mi;
+#endif
+
+   subsystems = Allocate(sizeof(SubsystemNode) * MAX_SUBSYSTEMS);
+   subsystemCount = 0;
+   for(x = 0; x < RESOURCE_HASH_SIZE; x++) {
+      for(rp = resources[x]; rp; rp = rp->next) {
+         sp = GetSubsystem(rp->file);
+         sp->count[rp->type] += 1;
+         sp->bytes += rp->size;
+      }
+   }
+#ifdef DEBUG
+   DEBUG_ForEachSite(AddHeapSite);
+#endif
+   qsort(subsystems, subsystemCount, sizeof(SubsystemNode),
+         CompareSubsystems);
+
+   report = NULL;
+   *length = 0;
+   AppendReport(&report, length, "%-12s", "subsystem");
+   for(y = 0; y < RESOURCE_COUNT; y++) {
+      AppendReport(&report, length, " %8s", RESOURCE_NAMES[y]);
+   }
+   AppendReport(&report, length, " %10s", "server KB");
+#ifdef DEBUG
+   AppendReport(&report, length, " %10s %8s", "heap KB", "blocks");
+#endif
+   AppendReport(&report, length, "\n");
+
+   memset(&total, 0, sizeof(total));
+   for(x = 0; x < subsystemCount; x++) {
+      sp = &subsystems[x];
+      AppendReport(&report, length, "%-12s", sp->name);
+      for(y = 0; y < RESOURCE_COUNT; y++) {
+         AppendReport(&report, length, " %8lu", sp->count[y]);
+         total.count[y] += sp->count[y];
+      }
+      AppendReport(&report, length, " %10lu", (sp->bytes + 1023) / 1024);
+#ifdef DEBUG
+      AppendReport(&report, length, " %10lu %8lu",
+                   (sp->heapBytes + 1023) / 1024, sp->heapBlocks);
+#endif
+      AppendReport(&report, length, "\n");
+      total.bytes += sp->bytes;
+      total.heapBytes += sp->heapBytes;
+      total.heapBlocks += sp->heapBlocks;
+   }
+
+   AppendReport(&report, length, "%-12s", "total");
+   for(y = 0; y < RESOURCE_COUNT; y++) {
+      AppendReport(&report, length, " %8lu", total.count[y]);
+   }
+   AppendReport(&report, length, " %10lu", (total.bytes + 1023) / 1024);
+#ifdef DEBUG
+   AppendReport(&report, length, " %10lu %8lu",
+                (total.heapBytes + 1023) / 1024, total.heapBlocks);
+#endif
+   AppendReport(&report, length, "\n");
+
+#ifdef HAVE_MALLINFO2
+   mi = mallinfo2();
+   AppendReport(&report, length, "heap: %lu KB in use, %lu KB mapped\n",
+                (unsigned long)(mi.uordblks + mi.hblkhd + 1023) / 1024,
+                (unsigned long)(mi.arena + mi.hblkhd + 1023) / 1024);
+#endif
+
+   Release(subsystems);
+   subsystems = NULL;
+
+   return report;
+
+}
+
+/** Append formatted text to a report. */
+void AppendReport(char **report, size_t *length, const char *format, ...) {
+
+   char line[REPORT_LINE_SIZE];
+   va_list ap;
+   size_t used;
+
+   va_start(ap, format);
+   used = vsnprintf(line, sizeof(line), format, ap);
+   va_end(ap);
+   if(used >= sizeof(line)) {
+      used = sizeof(line) - 1;
+   }
+
+   if(*report) {
+      *report = Reallocate(*report, *length + used + 1);
+   } else {
+      *report = Allocate(used + 1);
+   }
+   memcpy(&(*report)[*length], line, used + 1);
+   *length += used;
+
+}
+
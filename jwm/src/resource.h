@@ -0,0 +1,104 @@
+/**
+ * @file resource.h
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Header for X resource accounting.
+ *
+ * The JX wrappers in jxlib.h record each server resource JWM creates
+ * along with the source file that created it so the resources can be
+ * reported by subsystem.
+ *
+ */
+
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+/** Kinds of server resources that are counted. */
+typedef enum {
+   RESOURCE_PIXMAP,
+   RESOURCE_WINDOW,
+   RESOURCE_GC,
+   RESOURCE_PICTURE,
+   RESOURCE_CURSOR,
+   RESOURCE_FONT,
+   RESOURCE_COUNT
+} ResourceType;
+
+/*@{*/
+void InitializeResources();
+void StartupResources();
+void ShutdownResources();
+void DestroyResources();
+/*@}*/
+
+/** Record a resource.
+ * @param type The kind of resource.
+ * @param id The resource (None is ignored).
+ * @param file The source file that created it.
+ * @return The resource.
+ */
+unsigned long TrackResource(ResourceType type, unsigned long id,
+                            const char *file);
+
+/** Record a resource known by a client-side pointer (GCs and fonts).
+ * @param type The kind of resource.
+ * @param ptr The resource (NULL is ignored).
+ * @param file The source file that created it.
+ * @return The resource.
+ */
+void *TrackPointer(ResourceType type, void *ptr, const char *file);
+
+/** Forget a resource that is about to be freed.
+ * @param type The kind of resource.
+ * @param id The resource.
+ * @return The resource.
+ */
+unsigned long UntrackResource(ResourceType type, unsigned long id);
+
+/** Forget a resource known by a pointer that is about to be freed.
+ * @param type The kind of resource.
+ * @param ptr The resource.
+ * @return The resource.
+ */
+void *UntrackPointer(ResourceType type, void *ptr);
+
+/** Create a pixmap and record it with its size.
+ * The arguments are those of XCreatePixmap.
+ */
+Pixmap CreateTrackedPixmap(Display *d, Drawable drawable,
+                           unsigned int width, unsigned int height,
+                           unsigned int depth, const char *file);
+
+/** Create a bitmap from data and record it with its size.
+ * The arguments are those of XCreateBitmapFromData.
+ */
+Pixmap CreateTrackedBitmap(Display *d, Drawable drawable, const char *data,
+                           unsigned int width, unsigned int height,
+                           const char *file);
+
+/** Create a pixmap from bitmap data and record it with its size.
+ * The arguments are those of XCreatePixmapFromBitmapData.
+ */
+Pixmap CreateTrackedPixmapFromBitmap(Display *d, Drawable drawable,
+                                     char *data, unsigned int width,
+                                     unsigned int height, unsigned long fg,
+                                     unsigned long bg, unsigned int depth,
+                                     const char *file);
+
+/** Forget all resources.
+ * This is called when the connection to the X server is closed since
+ * the server frees everything that was left.
+ */
+void ForgetResources();
+
+/** Store a report of X resources and heap use in the _JWM_REPORT
+ * property on the root window.
+ */
+void WriteResourceReport();
+
+/** Write the report to stderr if one was requested with SIGUSR2. */
+void SignalResources();
+
+#endif /* RESOURCE_H */
+
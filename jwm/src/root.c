@@ -67,6 +67,15 @@ void StartupRootMenu() {
 
 /** Shutdown root menus. */
 void ShutdownRootMenu() {
+
+   int x;
+
+   for(x = 0; x < ROOT_MENU_COUNT; x++) {
+      if(rootMenu[x]) {
+         ReleaseMenuPixmaps(rootMenu[x]);
+      }
+   }
+
 }
 
 /** Destroy root menu data. */
@@ -110,7 +119,7 @@ void SetRootMenu(const char *indexes, Menu *m) {
          /* See if replacing this value will cause an orphan. */
          found = 0;
          for(y = 0; y < ROOT_MENU_COUNT; y++) {
-            if(x != y && rootMenu[y] == rootMenu[x]) {
+            if(y != index && rootMenu[y] == rootMenu[index]) {
                found = 1;
                break;
             }
@@ -153,6 +162,7 @@ void GetRootMenuSize(int index, int *width, int *height) {
    }
 
    PatchRootMenu(rootMenu[index]);
+   LayoutMenu(rootMenu[index]);
    *width = rootMenu[index]->width;
    *height = rootMenu[index]->height;
    UnpatchRootMenu(rootMenu[index]);
@@ -230,17 +240,12 @@ void Exit() {
    }
 }
 
-/** Reload the menu. */
+/** Reload the configuration.
+ * The reload is applied by the main event loop since the menus, trays,
+ * and pager may be in use by a menu or a move or resize loop.
+ */
 void ReloadMenu() {
 	shouldReload = 1;
-   if(!menuShown) {
-      ShutdownRootMenu();
-      DestroyRootMenu();
-      InitializeRootMenu();
-      ParseConfig(configPath);
-      StartupRootMenu();
-	   shouldReload = 0;
-   }
 }
 
 /** Root menu callback. */
@@ -56,7 +56,10 @@ void Restart();
 /** Exit the window manager. */
 void Exit();
 
-/** Reload the menu. */
+/** Reload the configuration.
+ * Root menus and key bindings are replaced in place; other changes
+ * restart JWM.
+ */
 void ReloadMenu();
 
 #endif /* ROOT_H */
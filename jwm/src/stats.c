@@ -0,0 +1,254 @@
+/**
+ * @file stats.c
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Event and redraw timing statistics.
+ *
+ * The time spent in each event handler and timed operation is kept
+ * in a histogram with power-of-two buckets in microseconds.
+ * The report also includes the use of the pixmap cache.
+ *
+ */
+
+#include "jwm.h"
+#include "stats.h"
+#include "main.h"
+#include "hint.h"
+#include "trace.h"
+#include "cache.h"
+
+/** Number of histogram buckets (the last one holds >= 2^19 us). */
+#define STATS_BUCKETS 20
+
+/** Maximum length of a line in the report. */
+#define STATS_LINE_SIZE 256
+
+/** Timing statistics for one handler. */
+typedef struct StatsNode {
+   unsigned long count;                   /**< Number of samples. */
+   unsigned long max;                     /**< Longest sample (us). */
+   double total;                          /**< Sum of samples (us). */
+   unsigned long buckets[STATS_BUCKETS];  /**< Log-scale histogram. */
+} StatsNode;
+
+static StatsNode profiles[PROFILE_COUNT];
+static StatsNode events[LASTEvent];
+
+static const char *PROFILE_NAMES[PROFILE_COUNT] = {
+   "DrawBorder",
+   "RenderTaskBar",
+   "UpdatePager",
+   "DrawTray",
+   "LoadNamedIcon",
+   "ParseConfig",
+   "RunCommand"
+};
+
+/** Trace categories of the operations in PROFILE_NAMES. */
+static const char *PROFILE_CATEGORIES[PROFILE_COUNT] = {
+   "draw",
+   "draw",
+   "draw",
+   "draw",
+   "icon",
+   "config",
+   "command"
+};
+
+/** Names of core X events; slot 0 is used for extension events. */
+static const char *EVENT_NAMES[] = {
+   "ExtensionEvent",    NULL,                "KeyPress",
+   "KeyRelease",        "ButtonPress",       "ButtonRelease",
+   "MotionNotify",      "EnterNotify",       "LeaveNotify",
+   "FocusIn",           "FocusOut",          "KeymapNotify",
+   "Expose",            "GraphicsExpose",    "NoExpose",
+   "VisibilityNotify",  "CreateNotify",      "DestroyNotify",
+   "UnmapNotify",       "MapNotify",         "MapRequest",
+   "ReparentNotify",    "ConfigureNotify",   "ConfigureRequest",
+   "GravityNotify",     "ResizeRequest",     "CirculateNotify",
+   "CirculateRequest",  "PropertyNotify",    "SelectionClear",
+   "SelectionRequest",  "SelectionNotify",   "ColormapNotify",
+   "ClientMessage",     "MappingNotify"
+};
+#define EVENT_NAME_COUNT (sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]))
+
+static void AddSample(StatsNode *sp, const char *name,
+                      const char *category, ProfileTime start);
+static void AppendStats(char **report, size_t *length,
+                        const char *name, const StatsNode *sp);
+static void AppendCacheStats(char **report, size_t *length);
+static void AppendLine(char **report, size_t *length,
+                       const char *line, size_t used);
+
+/** Get the start time for an operation to be timed. */
+ProfileTime StartProfile() {
+
+#ifdef CLOCK_MONOTONIC
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (ProfileTime)ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+#else
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return (ProfileTime)tv.tv_sec * 1000000UL + tv.tv_usec;
+#endif
+
+}
+
+/** Record the time taken by an operation. */
+void StopProfile(ProfileType type, ProfileTime start) {
+   AddSample(&profiles[type], PROFILE_NAMES[type],
+             PROFILE_CATEGORIES[type], start);
+}
+
+/** Record the time taken to handle an X event. */
+void StopEventProfile(int eventType, ProfileTime start) {
+
+   const char *name;
+
+   if(eventType < 0 || eventType >= LASTEvent) {
+      eventType = 0;
+   }
+   if(eventType < EVENT_NAME_COUNT && EVENT_NAMES[eventType]) {
+      name = EVENT_NAMES[eventType];
+   } else {
+      name = "Event";
+   }
+   AddSample(&events[eventType], name, "event", start);
+
+}
+
+/** Add a sample to a histogram and the trace. */
+void AddSample(StatsNode *sp, const char *name,
+               const char *category, ProfileTime start) {
+
+   unsigned long elapsed;
+   int bucket;
+
+   elapsed = StartProfile() - start;
+   AddTraceEvent(name, category, start, elapsed);
+
+   sp->count += 1;
+   sp->total += elapsed;
+   if(elapsed > sp->max) {
+      sp->max = elapsed;
+   }
+
+   bucket = 0;
+   while(bucket < STATS_BUCKETS - 1 && (elapsed >> (bucket + 1))) {
+      bucket += 1;
+   }
+   sp->buckets[bucket] += 1;
+
+}
+
+/** Store a report of the statistics on the root window. */
+void WriteStats() {
+
+   char name[32];
+   char *report;
+   size_t length;
+   int x;
+
+   report = NULL;
+   length = 0;
+   for(x = 0; x < LASTEvent; x++) {
+      if(x < EVENT_NAME_COUNT && EVENT_NAMES[x]) {
+         AppendStats(&report, &length, EVENT_NAMES[x], &events[x]);
+      } else {
+         snprintf(name, sizeof(name), "Event%d", x);
+         AppendStats(&report, &length, name, &events[x]);
+      }
+   }
+   for(x = 0; x < PROFILE_COUNT; x++) {
+      AppendStats(&report, &length, PROFILE_NAMES[x], &profiles[x]);
+   }
+   AppendCacheStats(&report, &length);
+
+   JXChangeProperty(display, rootWindow, atoms[ATOM_JWM_STATS],
+                    XA_STRING, 8, PropModeReplace,
+                    (unsigned char*)(report ? report : ""), length);
+
+   if(report) {
+      Release(report);
+   }
+
+}
+
+/** Append the statistics for one handler to a report. */
+void AppendStats(char **report, size_t *length,
+                 const char *name, const StatsNode *sp) {
+
+   char line[STATS_LINE_SIZE];
+   size_t used;
+   int x;
+
+   if(sp->count == 0) {
+      return;
+   }
+
+   used = snprintf(line, sizeof(line),
+                   "%-18s %8lu calls %10.1f ms %8lu us avg %8lu us max\n",
+                   name, sp->count, sp->total / 1000.0,
+                   (unsigned long)(sp->total / sp->count), sp->max);
+   for(x = 0; x < STATS_BUCKETS && used < sizeof(line); x++) {
+      if(!sp->buckets[x]) {
+         continue;
+      } else if(x == STATS_BUCKETS - 1) {
+         used += snprintf(&line[used], sizeof(line) - used,
+                          "  >=%lu us: %lu", 1UL << x, sp->buckets[x]);
+      } else {
+         used += snprintf(&line[used], sizeof(line) - used,
+                          "  <%lu us: %lu", 2UL << x, sp->buckets[x]);
+      }
+   }
+   if(used < sizeof(line) - 1) {
+      line[used++] = '\n';
+      line[used] = 0;
+   } else {
+      used = sizeof(line) - 1;
+   }
+   AppendLine(report, length, line, used);
+
+}
+
+/** Append the hit rate and size of the pixmap cache to a report. */
+void AppendCacheStats(char **report, size_t *length) {
+
+   char line[STATS_LINE_SIZE];
+   CacheStats cs;
+   unsigned long lookups;
+   size_t used;
+
+   GetCacheStats(&cs);
+   lookups = cs.hits + cs.misses;
+   used = snprintf(line, sizeof(line),
+                   "%-18s %8lu hits %8lu misses %5.1f%% hit rate"
+                   " %8lu evicted %6lu entries"
+                   " %8lu KB used %8lu KB peak %8lu KB limit\n",
+                   "PixmapCache", cs.hits, cs.misses,
+                   lookups ? 100.0 * cs.hits / lookups : 0.0,
+                   cs.evictions, cs.entries, (cs.bytes + 1023) / 1024,
+                   (cs.peak + 1023) / 1024, cs.limit / 1024);
+   if(used >= sizeof(line)) {
+      used = sizeof(line) - 1;
+   }
+   AppendLine(report, length, line, used);
+
+}
+
+/** Append a line to a report. */
+void AppendLine(char **report, size_t *length,
+                const char *line, size_t used) {
+
+   if(*report) {
+      *report = Reallocate(*report, *length + used + 1);
+   } else {
+      *report = Allocate(used + 1);
+   }
+   memcpy(&(*report)[*length], line, used + 1);
+   *length += used;
+
+}
+
@@ -0,0 +1,54 @@
+/**
+ * @file stats.h
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Header for event and redraw timing statistics.
+ *
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+/** Operations that are timed in addition to X events. */
+typedef enum {
+   PROFILE_DRAW_BORDER,
+   PROFILE_RENDER_TASKBAR,
+   PROFILE_UPDATE_PAGER,
+   PROFILE_DRAW_TRAY,
+   PROFILE_LOAD_ICON,
+   PROFILE_PARSE_CONFIG,
+   PROFILE_RUN_COMMAND,
+   PROFILE_COUNT
+} ProfileType;
+
+/** Start time of a timed operation in microseconds. */
+typedef unsigned long ProfileTime;
+
+/** Get the start time for an operation to be timed.
+ * @return The current time of a monotonic clock.
+ */
+ProfileTime StartProfile();
+
+/** Record the time taken by an operation.
+ * This also adds a span to the trace if one is being written.
+ * @param type The operation.
+ * @param start The time returned by StartProfile.
+ */
+void StopProfile(ProfileType type, ProfileTime start);
+
+/** Record the time taken to handle an X event.
+ * This also adds a span to the trace if one is being written.
+ * @param eventType The type of the event.
+ * @param start The time returned by StartProfile.
+ */
+void StopEventProfile(int eventType, ProfileTime start);
+
+/** Store a report of the statistics in the _JWM_STATS property
+ * on the root window.
+ * This includes the hit rate and size of the pixmap cache.
+ */
+void WriteStats();
+
+#endif /* STATS_H */
+
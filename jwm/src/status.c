@@ -130,6 +130,7 @@ void DrawMoveResizeWindow(const ClientNode *np, StatusWindowType type) {
 void DestroyMoveResizeWindow() {
 
    if(statusWindow != None) {
+      ForgetRoundedRectWindow(statusWindow);
       JXDestroyWindow(display, statusWindow);
       statusWindow = None;
    }
@@ -17,6 +17,10 @@
 #include "client.h"
 #include "event.h"
 #include "misc.h"
+#include "timing.h"
+
+/** Milliseconds to wait for swallowed programs at startup. */
+#define SWALLOW_TIMEOUT 5000
 
 typedef struct SwallowNode {
 
@@ -32,31 +36,150 @@ typedef struct SwallowNode {
 
 } SwallowNode;
 
+/** A swallowed window kept while the trays are rebuilt by a reload. */
+typedef struct RetainedNode {
+
+   char *name;
+   Window window;
+
+   struct RetainedNode *next;
+
+} RetainedNode;
+
 static SwallowNode *swallowNodes;
+static RetainedNode *retainedNodes = NULL;
+
+/** Set while the trays wait for swallowed programs to start. */
+static char waitingForSwallow;
+static TimeType swallowStart;
 
 static void Destroy(TrayComponentType *cp);
 static void Resize(TrayComponentType *cp);
+static int ProcessSwallowEvent(const XEvent *event, void *data);
+static void ResizeSwallowTray(SwallowNode *np);
+static void FinishSwallowStartup();
+static void SwallowWindow(SwallowNode *np, Window win);
+static void ReleaseSwallowWindow(Window win);
+static char AdoptRetainedWindow(SwallowNode *np);
+static void ReleaseRetainedNodes();
 
 /** Initialize swallow data. */
 void InitializeSwallow() {
    swallowNodes = NULL;
+   waitingForSwallow = 0;
 }
 
-/** Start swallow processing. */
+/** Start swallow processing.
+ * All swallowed programs are started at once. The trays are not laid
+ * out again until every program has been swallowed or SWALLOW_TIMEOUT
+ * has passed, so the trays change only once during startup.
+ * Programs kept by a reload are swallowed again instead of started.
+ */
 void StartupSwallow() {
 
    SwallowNode *np;
 
+   if(!swallowNodes) {
+      ReleaseRetainedNodes();
+      RunWaitingCommands(NULL);
+      return;
+   }
+
+   waitingForSwallow = 1;
+   GetCurrentTime(&swallowStart);
    for(np = swallowNodes; np; np = np->next) {
-      if(np->command) {
+      if(!AdoptRetainedWindow(np) && np->command) {
          RunCommand(np->command);
       }
    }
+   ReleaseRetainedNodes();
+
+   /* Stop waiting if a reload kept every swallowed window. */
+   for(np = swallowNodes; np; np = np->next) {
+      if(np->cp->window == None) {
+         break;
+      }
+   }
+   if(!np) {
+      FinishSwallowStartup();
+   }
 
 }
 
-/** Stop swallow processing. */
+/** Stop swallow processing.
+ * On a reload the swallowed windows are moved to the root window so
+ * they survive the trays and can be swallowed again by name.
+ */
 void ShutdownSwallow() {
+
+   SwallowNode *np;
+   RetainedNode *rp;
+
+   waitingForSwallow = 0;
+
+   if(!shouldReload) {
+      return;
+   }
+
+   for(np = swallowNodes; np; np = np->next) {
+      if(np->cp->window != None) {
+         UnregisterEventHandler(np->cp->window);
+         JXUnmapWindow(display, np->cp->window);
+         JXReparentWindow(display, np->cp->window, rootWindow, 0, 0);
+         rp = Allocate(sizeof(RetainedNode));
+         rp->name = CopyString(np->name);
+         rp->window = np->cp->window;
+         rp->next = retainedNodes;
+         retainedNodes = rp;
+         np->cp->window = None;
+      }
+   }
+
+}
+
+/** Stop waiting for swallowed programs once the timeout has passed. */
+void SignalSwallow(const TimeType *now) {
+   if(waitingForSwallow
+      && GetTimeDifference(now, &swallowStart) >= SWALLOW_TIMEOUT) {
+      FinishSwallowStartup();
+   }
+}
+
+/** Map the swallowed windows and lay out their trays. */
+void FinishSwallowStartup() {
+
+   SwallowNode *np;
+   SwallowNode *other;
+
+   waitingForSwallow = 0;
+
+   for(np = swallowNodes; np; np = np->next) {
+      if(np->cp->window != None) {
+         JXMapRaised(display, np->cp->window);
+      }
+   }
+
+   /* Resize each tray with swallowed windows once. */
+   for(np = swallowNodes; np; np = np->next) {
+      for(other = swallowNodes; other != np; other = other->next) {
+         if(other->cp->tray == np->cp->tray) {
+            break;
+         }
+      }
+      if(other == np) {
+         ResizeTray(np->cp->tray);
+      }
+   }
+
+   RunWaitingCommands(NULL);
+
+}
+
+/** Resize the tray of a swallowed window unless starting up. */
+void ResizeSwallowTray(SwallowNode *np) {
+   if(!waitingForSwallow) {
+      ResizeTrayComponent(np->cp);
+   }
 }
 
 /** Destroy swallow data. */
@@ -80,6 +203,48 @@ void DestroySwallow() {
 
    }
 
+   if(!shouldReload) {
+      ReleaseRetainedNodes();
+   }
+
+}
+
+/** Swallow a window kept by a reload with the name of a node.
+ * @return 1 if a window was swallowed, 0 otherwise.
+ */
+char AdoptRetainedWindow(SwallowNode *np) {
+
+   RetainedNode **lp;
+   RetainedNode *rp;
+
+   for(lp = &retainedNodes; *lp; lp = &(*lp)->next) {
+      rp = *lp;
+      if(!strcmp(rp->name, np->name)) {
+         SwallowWindow(np, rp->window);
+         *lp = rp->next;
+         Release(rp->name);
+         Release(rp);
+         return 1;
+      }
+   }
+
+   return 0;
+
+}
+
+/** Close the kept windows that are no longer swallowed. */
+void ReleaseRetainedNodes() {
+
+   RetainedNode *rp;
+
+   while(retainedNodes) {
+      rp = retainedNodes->next;
+      ReleaseSwallowWindow(retainedNodes->window);
+      Release(retainedNodes->name);
+      Release(retainedNodes);
+      retainedNodes = rp;
+   }
+
 }
 
 /** Create a swallowed application tray component. */
@@ -135,47 +300,42 @@ TrayComponentType *CreateSwallow(const char *name, const char *command,
 }
 
 /** Process an event on a swallowed window. */
-int ProcessSwallowEvent(const XEvent *event) {
+int ProcessSwallowEvent(const XEvent *event, void *data) {
 
-   SwallowNode *np;
+   SwallowNode *np = (SwallowNode*)data;
    int width, height;
 
-   for(np = swallowNodes; np; np = np->next) {
-      if(event->xany.window == np->cp->window) {
-         switch(event->type) {
-         case DestroyNotify:
-            np->cp->window = None;
-            np->cp->requestedWidth = 1;
-            np->cp->requestedHeight = 1;
-            ResizeTray(np->cp->tray);
-            break;
-         case ResizeRequest:
-            np->cp->requestedWidth
-               = event->xresizerequest.width + np->border * 2;
-            np->cp->requestedHeight
-               = event->xresizerequest.height + np->border * 2;
-            ResizeTray(np->cp->tray);
-            break;
-         case ConfigureNotify:
-            /* I don't think this should be necessary, but somehow
-             * resize requests slip by sometimes... */
-            width = event->xconfigure.width + np->border * 2;
-            height = event->xconfigure.height + np->border * 2;
-            if(   width != np->cp->requestedWidth
-               && height != np->cp->requestedHeight) {
-               np->cp->requestedWidth = width;
-               np->cp->requestedHeight = height;
-               ResizeTray(np->cp->tray);
-            }
-            break;
-         default:
-            break;
-         }
-         return 1;
+   switch(event->type) {
+   case DestroyNotify:
+      UnregisterEventHandler(np->cp->window);
+      np->cp->window = None;
+      np->cp->requestedWidth = 1;
+      np->cp->requestedHeight = 1;
+      ResizeSwallowTray(np);
+      break;
+   case ResizeRequest:
+      np->cp->requestedWidth
+         = event->xresizerequest.width + np->border * 2;
+      np->cp->requestedHeight
+         = event->xresizerequest.height + np->border * 2;
+      ResizeSwallowTray(np);
+      break;
+   case ConfigureNotify:
+      /* I don't think this should be necessary, but somehow
+       * resize requests slip by sometimes... */
+      width = event->xconfigure.width + np->border * 2;
+      height = event->xconfigure.height + np->border * 2;
+      if(   width != np->cp->requestedWidth
+         && height != np->cp->requestedHeight) {
+         np->cp->requestedWidth = width;
+         np->cp->requestedHeight = height;
+         ResizeSwallowTray(np);
       }
+      break;
+   default:
+      break;
    }
-
-   return 0;
+   return 1;
 
 }
 
@@ -200,22 +360,57 @@ void Resize(TrayComponentType *cp) {
 /** Destroy a swallow tray component. */
 void Destroy(TrayComponentType *cp) {
 
-   ClientProtocolType protocols;
-
    /* Destroy the window if there is one. */
    if(cp->window) {
+      ReleaseSwallowWindow(cp->window);
+   }
 
-      JXReparentWindow(display, cp->window, rootWindow, 0, 0);
-      JXRemoveFromSaveSet(display, cp->window);
+}
 
-      protocols = ReadWMProtocols(cp->window);
-      if(protocols & PROT_DELETE) {
-         SendClientMessage(cp->window, ATOM_WM_PROTOCOLS,
-            ATOM_WM_DELETE_WINDOW);
-      } else {
-         JXKillClient(display, cp->window);
-      }
+/** Give a swallowed window back to the root window and close it. */
+void ReleaseSwallowWindow(Window win) {
+
+   ClientProtocolType protocols;
+
+   UnregisterEventHandler(win);
+
+   JXReparentWindow(display, win, rootWindow, 0, 0);
+   JXRemoveFromSaveSet(display, win);
+
+   protocols = ReadWMProtocols(win);
+   if(protocols & PROT_DELETE) {
+      SendClientMessage(win, ATOM_WM_PROTOCOLS, ATOM_WM_DELETE_WINDOW);
+   } else {
+      JXKillClient(display, win);
+   }
+
+}
+
+/** Reparent a window into the tray of a node. */
+void SwallowWindow(SwallowNode *np, Window win) {
+
+   XWindowAttributes attr;
+
+   Assert(np->cp->tray->window != None);
 
+   JXSelectInput(display, win, StructureNotifyMask | ResizeRedirectMask);
+   JXAddToSaveSet(display, win);
+   JXSetWindowBorder(display, win, colors[COLOR_TRAY_BG]);
+   JXReparentWindow(display, win, np->cp->tray->window, 0, 0);
+   if(!waitingForSwallow) {
+      JXMapRaised(display, win);
+   }
+   np->cp->window = win;
+   RegisterEventHandler(win, ProcessSwallowEvent, np);
+
+   /* Update the size. */
+   JXGetWindowAttributes(display, win, &attr);
+   np->border = attr.border_width;
+   if(!np->userWidth) {
+      np->cp->requestedWidth = attr.width + 2 * np->border;
+   }
+   if(!np->userHeight) {
+      np->cp->requestedHeight = attr.height + 2 * np->border;
    }
 
 }
@@ -225,7 +420,6 @@ int CheckSwallowMap(const XMapEvent *event) {
 
    SwallowNode *np;
    XClassHint hint;
-   XWindowAttributes attr;
 
    for(np = swallowNodes; np; np = np->next) {
 
@@ -239,29 +433,24 @@ int CheckSwallowMap(const XMapEvent *event) {
          if(!strcmp(hint.res_name, np->name)) {
 
             /* Swallow the window. */
-            JXSelectInput(display, event->window,
-                 StructureNotifyMask | ResizeRedirectMask);
-            JXAddToSaveSet(display, event->window);
-            JXSetWindowBorder(display, event->window, colors[COLOR_TRAY_BG]);
-            JXReparentWindow(display, event->window,
-               np->cp->tray->window, 0, 0);
-            JXMapRaised(display, event->window);
             JXFree(hint.res_name);
             JXFree(hint.res_class);
-            np->cp->window = event->window;
-
-            /* Update the size. */
-            JXGetWindowAttributes(display, event->window, &attr);
-            np->border = attr.border_width;
-            if(!np->userWidth) {
-               np->cp->requestedWidth = attr.width + 2 * np->border;
-            }
-            if(!np->userHeight) {
-               np->cp->requestedHeight = attr.height + 2 * np->border;
+            SwallowWindow(np, event->window);
+
+            RunWaitingCommands(np->name);
+            if(!waitingForSwallow) {
+               ResizeTrayComponent(np->cp);
+            } else {
+               for(np = swallowNodes; np; np = np->next) {
+                  if(np->cp->window == None) {
+                     break;
+                  }
+               }
+               if(!np) {
+                  FinishSwallowStartup();
+               }
             }
 
-            ResizeTray(np->cp->tray);
-
             return 1;
 
          } else {
@@ -10,6 +10,9 @@
 #ifndef SWALLOW_H
 #define SWALLOW_H
 
+struct TrayComponentType;
+struct TimeType;
+
 /*@{*/
 void InitializeSwallow();
 void StartupSwallow();
@@ -33,11 +36,10 @@ struct TrayComponentType *CreateSwallow(
  */
 int CheckSwallowMap(const XMapEvent *event);
 
-/** Process an event on a swallowed window.
- * @param event The event to process.
- * @return 1 if the event was for a swallowed window, 0 if not.
+/** Stop waiting for swallowed programs at startup after a timeout.
+ * @param now The current time.
  */
-int ProcessSwallowEvent(const XEvent *event);
+void SignalSwallow(const struct TimeType *now);
 
 #endif /* SWALLOW_H */
 
@@ -23,6 +23,7 @@
 #include "font.h"
 #include "winmenu.h"
 #include "screen.h"
+#include "stats.h"
 
 typedef enum {
    INSERT_LEFT,
@@ -65,8 +66,11 @@ static Pixmap minimizedPixmap;
 static InsertModeType insertMode;
 
 static TaskBarType *bars;
-static Node *taskBarNodes;
-static Node *taskBarNodesTail;
+
+/* Every managed client has a node. The list is emptied as clients are
+ * removed, so it is kept when the trays are created again. */
+static Node *taskBarNodes = NULL;
+static Node *taskBarNodesTail = NULL;
 
 static Node *GetNode(TaskBarType *bar, int x);
 static unsigned int GetItemCount();
@@ -86,8 +90,6 @@ static void ProcessTaskMotionEvent(TrayComponentType *cp,
 /** Initialize task bar data. */
 void InitializeTaskBar() {
    bars = NULL;
-   taskBarNodes = NULL;
-   taskBarNodesTail = NULL;
    insertMode = INSERT_RIGHT;
 }
 
@@ -409,7 +411,7 @@ void UpdateTaskBar() {
          bp->cp->requestedHeight *= count;
          bp->cp->requestedHeight += 2;
          if(lastHeight != bp->cp->requestedHeight) {
-            ResizeTray(bp->cp->tray);
+            ResizeTrayComponent(bp->cp);
          }
       }
 
@@ -454,11 +456,14 @@ void Render(const TaskBarType *bp) {
    Pixmap buffer;
    GC gc;
    char *minimizedName;
+   ProfileTime start;
 
    if(shouldExit) {
       return;
    }
 
+   start = StartProfile();
+
    Assert(bp);
    Assert(bp->cp);
 
@@ -477,6 +482,7 @@ void Render(const TaskBarType *bp) {
    itemCount = GetItemCount();
    if(!itemCount) {
       UpdateSpecificTray(bp->cp->tray, bp->cp);
+      StopProfile(PROFILE_RENDER_TASKBAR, start);
       return;
    }
    if(bp->layout == LAYOUT_HORIZONTAL) {
@@ -554,6 +560,7 @@ void Render(const TaskBarType *bp) {
    }
 
    UpdateSpecificTray(bp->cp->tray, bp->cp);
+   StopProfile(PROFILE_RENDER_TASKBAR, start);
 
 }
 
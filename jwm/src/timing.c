@@ -9,9 +9,18 @@
 
 #include "jwm.h"
 #include "timing.h"
+#include "main.h"
 
 static const unsigned long MAX_TIME_SECONDS = 60;
 
+unsigned long roundTripCount = 0;
+char showTiming = 0;
+
+static const char *phaseName = NULL;
+static TimeType phaseStart;
+static unsigned long phaseRoundTrips;
+static unsigned long phaseRequest;
+
 /** Get the current time in milliseconds since midnight 1970-01-01 UTC. */
 void GetCurrentTime(TimeType *t) {
    struct timeval val;
@@ -93,4 +102,38 @@ const char *GetTimeString(const char *format, const char *zone) {
 
 }
 
+/** Start timing a startup phase. */
+void StartTimingPhase(const char *name) {
+
+   if(!showTiming) {
+      return;
+   }
+
+   StopTimingPhase();
+
+   phaseName = name;
+   phaseRoundTrips = roundTripCount;
+   phaseRequest = display ? NextRequest(display) : 0;
+   GetCurrentTime(&phaseStart);
+
+}
 
+/** Stop timing the current phase. */
+void StopTimingPhase() {
+
+   TimeType now;
+   unsigned long requests;
+
+   if(!phaseName) {
+      return;
+   }
+
+   GetCurrentTime(&now);
+   requests = display ? NextRequest(display) - phaseRequest : 0;
+   fprintf(stderr, "timing: %-12s %6lu ms %6lu round trips %6lu requests\n",
+           phaseName, GetTimeDifference(&phaseStart, &now),
+           roundTripCount - phaseRoundTrips, requests);
+
+   phaseName = NULL;
+
+}
@@ -43,5 +43,20 @@ unsigned long GetTimeDifference(const TimeType *t1, const TimeType *t2);
  */
 const char *GetTimeString(const char *format, const char *zone);
 
+/** Set to report the cost of each startup phase (-timing). */
+extern char showTiming;
+
+/** Start timing a startup phase.
+ * This ends the previous phase, if any. Nothing is done unless
+ * showTiming is set.
+ * @param name The name of the phase (must remain valid).
+ */
+void StartTimingPhase(const char *name);
+
+/** Stop timing the current phase and report the time, round trips,
+ * and requests used to stderr.
+ */
+void StopTimingPhase();
+
 #endif /* TIMING_H */
 
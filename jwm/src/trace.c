@@ -0,0 +1,114 @@
+/**
+ * @file trace.c
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Event tracing (-trace).
+ *
+ * Spans are kept in a fixed ring buffer and written to the trace file
+ * when the event loop is about to block or when the buffer fills.
+ *
+ */
+
+#include "jwm.h"
+#include "trace.h"
+#include "error.h"
+
+/** Number of spans buffered before the trace file is written. */
+#define TRACE_BUFFER_SIZE 4096
+
+/** A completed span. */
+typedef struct TraceNode {
+   const char *name;
+   const char *category;
+   ProfileTime start;
+   unsigned long duration;
+} TraceNode;
+
+static FILE *traceFile = NULL;
+static TraceNode traceBuffer[TRACE_BUFFER_SIZE];
+static unsigned int traceHead = 0;
+static unsigned int traceCount = 0;
+static int tracePid;
+
+/** Start writing trace events to a file. */
+void OpenTrace(const char *fileName) {
+
+   Assert(fileName);
+
+   traceFile = fopen(fileName, "w");
+   if(JUNLIKELY(!traceFile)) {
+      Warning(_("could not open trace file %s"), fileName);
+      return;
+   }
+#ifdef HAVE_FCNTL_H
+   /* Programs we start should not inherit the trace file. */
+   fcntl(fileno(traceFile), F_SETFD, FD_CLOEXEC);
+#endif
+
+   tracePid = (int)getpid();
+   traceHead = 0;
+   traceCount = 0;
+   fputs("[\n", traceFile);
+
+}
+
+/** Record a completed span. */
+void AddTraceEvent(const char *name, const char *category,
+                   ProfileTime start, unsigned long duration) {
+
+   TraceNode *tp;
+
+   if(JLIKELY(!traceFile)) {
+      return;
+   }
+
+   if(JUNLIKELY(traceCount == TRACE_BUFFER_SIZE)) {
+      FlushTrace();
+   }
+
+   tp = &traceBuffer[(traceHead + traceCount) % TRACE_BUFFER_SIZE];
+   tp->name = name;
+   tp->category = category;
+   tp->start = start;
+   tp->duration = duration;
+   traceCount += 1;
+
+}
+
+/** Write buffered trace events to the trace file. */
+void FlushTrace() {
+
+   TraceNode *tp;
+
+   if(!traceFile || traceCount == 0) {
+      return;
+   }
+
+   while(traceCount > 0) {
+      tp = &traceBuffer[traceHead];
+      fprintf(traceFile, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+              "\"ts\":%lu,\"dur\":%lu,\"pid\":%d,\"tid\":%d},\n",
+              tp->name, tp->category, tp->start, tp->duration,
+              tracePid, tracePid);
+      traceHead = (traceHead + 1) % TRACE_BUFFER_SIZE;
+      traceCount -= 1;
+   }
+   fflush(traceFile);
+
+}
+
+/** Flush and close the trace file. */
+void CloseTrace() {
+
+   if(traceFile) {
+      FlushTrace();
+
+      /* An empty object avoids a trailing comma. */
+      fputs("{}]\n", traceFile);
+      fclose(traceFile);
+      traceFile = NULL;
+   }
+
+}
+
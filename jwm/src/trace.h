@@ -0,0 +1,38 @@
+/**
+ * @file trace.h
+ * @author the JWM project
+ * @date 2026
+ *
+ * @brief Header for event tracing (-trace).
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "stats.h"
+
+/** Start writing trace events to a file.
+ * Events are written in the Chrome Trace Event JSON format.
+ * @param fileName The file to create.
+ */
+void OpenTrace(const char *fileName);
+
+/** Record a completed span.
+ * Nothing is done unless a trace file is open.
+ * @param name The name of the span (must remain valid).
+ * @param category The category of the span (must remain valid).
+ * @param start The start time from StartProfile.
+ * @param duration The duration in microseconds.
+ */
+void AddTraceEvent(const char *name, const char *category,
+                   ProfileTime start, unsigned long duration);
+
+/** Write buffered trace events to the trace file. */
+void FlushTrace();
+
+/** Flush and close the trace file. */
+void CloseTrace();
+
+#endif /* TRACE_H */
+
@@ -18,6 +18,8 @@
 #include "menu.h"
 #include "timing.h"
 #include "screen.h"
+#include "event.h"
+#include "stats.h"
 
 #define DEFAULT_TRAY_WIDTH 32
 #define DEFAULT_TRAY_HEIGHT 32
@@ -27,6 +29,7 @@ static Window supportingWindow;
 static int trayCount;
 static unsigned int trayOpacity;
 
+static int ProcessTrayEvent(const XEvent *event, void *data);
 static void HandleTrayExpose(TrayType *tp, const XExposeEvent *event);
 static void HandleTrayEnterNotify(TrayType *tp, const XCrossingEvent *event);
 
@@ -42,6 +45,7 @@ static int ComputeMaxHeight(TrayType *tp);
 static int ComputeTotalHeight(TrayType *tp);
 static int CheckHorizontalFill(TrayType *tp);
 static int CheckVerticalFill(TrayType *tp);
+static void RelayoutTray(TrayType *tp, TrayComponentType *changed);
 static void LayoutTray(TrayType *tp, int *variableSize,
                        int *variableRemainder);
 
@@ -104,6 +108,7 @@ void StartupTray() {
       }
 
       SetDefaultCursor(tp->window);
+      RegisterEventHandler(tp->window, ProcessTrayEvent, tp);
 
       /* Create and layout items on the tray. */
       xoffset = tp->border;
@@ -178,11 +183,12 @@ void ShutdownTray() {
             (cp->Destroy)(cp);
          }
       }
+      UnregisterEventHandler(tp->window);
       JXDestroyWindow(display, tp->window);
    }
 
    if(supportingWindow != None) {
-      XDestroyWindow(display, supportingWindow);
+      JXDestroyWindow(display, supportingWindow);
       supportingWindow = None;
    }
 
@@ -615,37 +621,31 @@ void HideTray(TrayType *tp) {
 
 }
 
-/** Process a tray event. */
-int ProcessTrayEvent(const XEvent *event) {
-
-   TrayType *tp;
-
-   for(tp = trays; tp; tp = tp->next) {
-      if(event->xany.window == tp->window) {
-         switch(event->type) {
-         case Expose:
-            HandleTrayExpose(tp, &event->xexpose);
-            return 1;
-         case EnterNotify:
-            HandleTrayEnterNotify(tp, &event->xcrossing);
-            return 1;
-         case ButtonPress:
-            HandleTrayButtonPress(tp, &event->xbutton);
-            return 1;
-         case ButtonRelease:
-            HandleTrayButtonRelease(tp, &event->xbutton);
-            return 1;
-         case MotionNotify:
-            HandleTrayMotionNotify(tp, &event->xmotion);
-            return 1;
-         default:
-            return 0;
-         }
-      }
+/** Process an event on a tray window. */
+int ProcessTrayEvent(const XEvent *event, void *data) {
+
+   TrayType *tp = (TrayType*)data;
+
+   switch(event->type) {
+   case Expose:
+      HandleTrayExpose(tp, &event->xexpose);
+      return 1;
+   case EnterNotify:
+      HandleTrayEnterNotify(tp, &event->xcrossing);
+      return 1;
+   case ButtonPress:
+      HandleTrayButtonPress(tp, &event->xbutton);
+      return 1;
+   case ButtonRelease:
+      HandleTrayButtonRelease(tp, &event->xbutton);
+      return 1;
+   case MotionNotify:
+      HandleTrayMotionNotify(tp, &event->xmotion);
+      return 1;
+   default:
+      return 0;
    }
 
-   return 0;
-
 }
 
 /** Signal the tray (needed for autohide). */
@@ -774,14 +774,17 @@ void HandleTrayMotionNotify(TrayType *tp, const XMotionEvent *event) {
 void DrawTray() {
 
    TrayType *tp;
+   ProfileTime start;
 
    if(shouldExit) {
       return;
    }
 
+   start = StartProfile();
    for(tp = trays; tp; tp = tp->next) {
       DrawSpecificTray(tp);
    }
+   StopProfile(PROFILE_DRAW_TRAY, start);
 
 }
 
@@ -906,22 +909,64 @@ void LayoutTray(TrayType *tp, int *variableSize, int *variableRemainder) {
 
 /** Resize a tray. */
 void ResizeTray(TrayType *tp) {
+   Assert(tp);
+   RelayoutTray(tp, NULL);
+}
+
+/** Resize a tray after a component changed its requested size. */
+void ResizeTrayComponent(TrayComponentType *cp) {
+   Assert(cp);
+   Assert(cp->tray);
+   RelayoutTray(cp->tray, cp);
+}
+
+/** Lay out a tray and update the components that changed.
+ * If changed is NULL, every component is resized and the whole tray is
+ * redrawn. Otherwise only the changed component, components that
+ * change size, and components that move are updated.
+ */
+void RelayoutTray(TrayType *tp, TrayComponentType *changed) {
 
    TrayComponentType *cp;
+   int *oldSizes;
    int variableSize;
    int variableRemainder;
    int xoffset, yoffset;
    int width, height;
+   int oldx, oldy, oldWidth, oldHeight;
+   int count, index;
+   char moved, resized;
+   char trayChanged;
 
-   Assert(tp);
+   /* Save the current sizes so we can tell what changed. */
+   count = 0;
+   for(cp = tp->components; cp; cp = cp->next) {
+      ++count;
+   }
+   oldSizes = AllocateStack(sizeof(int) * (2 * count + 1));
+   index = 0;
+   for(cp = tp->components; cp; cp = cp->next) {
+      oldSizes[index++] = cp->width;
+      oldSizes[index++] = cp->height;
+   }
+   oldx = tp->x;
+   oldy = tp->y;
+   oldWidth = tp->width;
+   oldHeight = tp->height;
 
    LayoutTray(tp, &variableSize, &variableRemainder);
 
+   trayChanged = !changed
+      || tp->x != oldx || tp->y != oldy
+      || tp->width != oldWidth || tp->height != oldHeight;
+
    /* Reposition items on the tray. */
    xoffset = tp->border;
    yoffset = tp->border;
+   index = 0;
    for(cp = tp->components; cp; cp = cp->next) {
 
+      moved = cp->x != xoffset || cp->y != yoffset;
       cp->x = xoffset;
       cp->y = yoffset;
       cp->screenx = tp->x + xoffset;
@@ -951,13 +996,24 @@ void ResizeTray(TrayType *tp) {
          }
          cp->width = width;
          cp->height = height;
+      }
+      resized = cp->width != oldSizes[index]
+             || cp->height != oldSizes[index + 1];
+      index += 2;
+
+      if(cp->Resize && (!changed || cp == changed || resized)) {
          (cp->Resize)(cp);
       }
 
-      if(cp->window != None) {
+      if(cp->window != None && (!changed || moved)) {
          JXMoveWindow(display, cp->window, xoffset, yoffset);
       }
 
+      /* Redraw only what moved when the tray itself is unchanged. */
+      if(!trayChanged && (cp == changed || moved || resized)) {
+         UpdateSpecificTray(tp, cp);
+      }
+
       if(tp->layout == LAYOUT_HORIZONTAL) {
          xoffset += cp->width;
       } else {
@@ -965,14 +1021,20 @@ void ResizeTray(TrayType *tp) {
       }
    }
 
-   JXMoveResizeWindow(display, tp->window, tp->x, tp->y,
-      tp->width, tp->height);
+   ReleaseStack(oldSizes);
 
-   UpdateTaskBar();
-   DrawSpecificTray(tp);
+   if(trayChanged) {
+
+      JXMoveResizeWindow(display, tp->window, tp->x, tp->y,
+         tp->width, tp->height);
+
+      UpdateTaskBar();
+      DrawSpecificTray(tp);
+
+      if(tp->hidden) {
+         HideTray(tp);
+      }
 
-   if(tp->hidden) {
-      HideTray(tp);
    }
 
 }
@@ -41,7 +41,7 @@ typedef enum {
  * Resizing is handled as follows:
  *  - A component determines that it needs to change size. It updates
  *    its requested size (0 for no preference).
- *  - The component calls ResizeTray.
+ *  - The component calls ResizeTrayComponent.
  *  - The SetSize callback is issued with size constraints
  *    (0 for no constraint). The component should update
  *    width and height in SetSize.
@@ -195,6 +195,14 @@ void UpdateSpecificTray(const TrayType *tp, const TrayComponentType *cp);
  */
 void ResizeTray(TrayType *tp);
 
+/** Resize a tray after a component changed its requested size.
+ * Only the component and the components that move or change size as a
+ * result are updated. The whole tray is redrawn only if the tray
+ * itself moves or changes size.
+ * @param cp The component whose requested size changed.
+ */
+void ResizeTrayComponent(TrayComponentType *cp);
+
 /** Get a linked list of trays.
  * @return The trays.
  */
@@ -212,12 +220,6 @@ int GetTrayCount();
  */
 Window GetSupportingWindow();
 
-/** Process an event that may be for a tray.
- * @param event The event to process.
- * @return 1 if this event was for a tray, 0 otherwise.
- */
-int ProcessTrayEvent(const XEvent *event);
-
 /** Signal the trays.
  * This function is called regularly so that autohide, etc. can take place.
  * @param now The current time.
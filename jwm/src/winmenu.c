@@ -38,6 +38,7 @@ void GetWindowMenuSize(ClientNode *np, int *width, int *height) {
    client = np;
    menu = CreateWindowMenu();
    InitializeMenu(menu);
+   LayoutMenu(menu);
    *width = menu->width;
    *height = menu->height;
    DestroyMenu(menu);